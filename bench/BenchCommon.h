@@ -0,0 +1,45 @@
+//
+// Timing helpers shared by the benchmarks.
+//
+
+#ifndef VKH_BENCH_COMMON_H_
+#define VKH_BENCH_COMMON_H_
+
+#include <chrono>
+#include <stdint.h>
+
+namespace vkh_bench {
+    typedef std::chrono::steady_clock Clock;
+
+    inline double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // keeps the optimizer from discarding benchmarked results
+    inline void consume(uint64_t value) {
+        static volatile uint64_t sink;
+        sink = sink + value;
+    }
+
+    // deterministic xorshift so runs are comparable
+    class Random {
+        public:
+            Random(uint64_t seed) : _state(seed) {}
+
+            uint64_t next() {
+                _state ^= _state << 13;
+                _state ^= _state >> 7;
+                _state ^= _state << 17;
+                return _state;
+            }
+
+            uint32_t below(uint32_t bound) {
+                return (uint32_t)(next() % bound);
+            }
+
+        private:
+            uint64_t _state;
+    };
+}
+
+#endif //VKH_BENCH_COMMON_H_
@@ -0,0 +1,99 @@
+// Compares VkHandleSlotMap against std::unordered_map<uint64_t, VkUniqueHandle<T>> for
+// random id lookups and for iterating every raw handle.
+
+#include "BenchCommon.h"
+#include "StubDriver.h"
+#include "vkh/VkHandleSlotMap.h"
+#include <unordered_map>
+#include <vector>
+#include <stdio.h>
+
+using namespace vkh;
+using namespace vkh_bench;
+
+namespace {
+    const uint32_t HANDLE_COUNT = 100000;
+    const uint32_t LOOKUP_COUNT = 10000000;
+    const uint32_t ITERATION_PASSES = 200;
+
+    void report(const char* container, double lookupSeconds, double iterateSeconds) {
+        double lookupNs = lookupSeconds * 1e9 / LOOKUP_COUNT;
+        double handleBytes = (double)HANDLE_COUNT * ITERATION_PASSES * sizeof(VkBuffer);
+        printf("%-14s lookup %6.2f ns/op   iterate %8.1f MB/s (%.2f ns/handle)\n", container, lookupNs,
+            handleBytes / iterateSeconds / 1e6, iterateSeconds * 1e9 / ((double)HANDLE_COUNT * ITERATION_PASSES));
+    }
+}
+
+int main() {
+    stub::setRecording(false);
+    VkDevice device = stub::makeHandle<VkDevice>();
+
+    // erase a third of the handles so both containers have seen churn
+    VkHandleSlotMap<VkBuffer> slotMap;
+    std::unordered_map<uint64_t, VkUniqueHandle<VkBuffer>> hashMap;
+    std::vector<VkHandleId> ids;
+    std::vector<uint64_t> keys;
+    Random random(42);
+    for(uint32_t i = 0; i < HANDLE_COUNT * 3 / 2; i++) {
+        ids.push_back(slotMap.insert(VkUniqueHandle<VkBuffer>(stub::makeHandle<VkBuffer>(), device)));
+        VkBuffer buffer = stub::makeHandle<VkBuffer>();
+        keys.push_back((uint64_t)buffer);
+        hashMap.emplace((uint64_t)buffer, VkUniqueHandle<VkBuffer>(buffer, device));
+    }
+    while(ids.size() > HANDLE_COUNT) {
+        uint32_t victim = random.below((uint32_t)ids.size());
+        slotMap.erase(ids[victim]);
+        hashMap.erase(keys[victim]);
+        ids[victim] = ids.back();
+        keys[victim] = keys.back();
+        ids.pop_back();
+        keys.pop_back();
+    }
+
+    std::vector<uint32_t> order(LOOKUP_COUNT);
+    for(auto& index : order) {
+        index = random.below(HANDLE_COUNT);
+    }
+
+    Clock::time_point start = Clock::now();
+    uint64_t sum = 0;
+    for(uint32_t index : order) {
+        sum += (uint64_t)slotMap.get(ids[index]);
+    }
+    double slotLookup = secondsSince(start);
+    consume(sum);
+
+    start = Clock::now();
+    sum = 0;
+    for(uint32_t pass = 0; pass < ITERATION_PASSES; pass++) {
+        const VkBuffer* handles = slotMap.data();
+        for(uint32_t i = 0; i < slotMap.size(); i++) {
+            sum += (uint64_t)handles[i];
+        }
+        consume(sum);
+    }
+    double slotIterate = secondsSince(start);
+
+    start = Clock::now();
+    sum = 0;
+    for(uint32_t index : order) {
+        sum += (uint64_t)hashMap.find(keys[index])->second.get();
+    }
+    double hashLookup = secondsSince(start);
+    consume(sum);
+
+    start = Clock::now();
+    sum = 0;
+    for(uint32_t pass = 0; pass < ITERATION_PASSES; pass++) {
+        for(auto& entry : hashMap) {
+            sum += (uint64_t)entry.second.get();
+        }
+        consume(sum);
+    }
+    double hashIterate = secondsSince(start);
+
+    printf("%u handles, %u random lookups, %u iteration passes\n", HANDLE_COUNT, LOOKUP_COUNT, ITERATION_PASSES);
+    report("slot map", slotLookup, slotIterate);
+    report("unordered_map", hashLookup, hashIterate);
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Measures planTransientAliasing over synthetic render graphs: planning time and memory saved.
+// The lower bound is the peak of memory simultaneously alive in any pass, which no placement can beat.
+
+#include "BenchCommon.h"
+#include "vkh/VkTransientAliasing.h"
+#include <algorithm>
+#include <vector>
+#include <stdio.h>
+
+using namespace vkh;
+using namespace vkh_bench;
+
+namespace {
+    const VkDeviceSize MB = 1024 * 1024;
+
+    // render-target sized resources: mostly short-lived, a few spanning most of the frame
+    std::vector<VkTransientResourceInfo> makeGraph(uint32_t resourceCount, uint32_t passCount, Random& random) {
+        std::vector<VkTransientResourceInfo> resources(resourceCount);
+        for(auto& resource : resources) {
+            uint32_t length = random.below(8) == 0 ? passCount / 2 : 1 + random.below(4);
+            resource.firstPass = random.below(passCount);
+            resource.lastPass = std::min(resource.firstPass + length - 1, passCount - 1);
+            resource.requirements.size = (VkDeviceSize)(1 + random.below(64)) * 256 * 1024;
+            resource.requirements.alignment = random.below(2) == 0 ? 4096 : 65536;
+            resource.requirements.memoryTypeBits = 0x1;
+        }
+        return resources;
+    }
+
+    VkDeviceSize peakLiveSize(const std::vector<VkTransientResourceInfo>& resources, uint32_t passCount) {
+        VkDeviceSize peak = 0;
+        for(uint32_t pass = 0; pass < passCount; pass++) {
+            VkDeviceSize live = 0;
+            for(auto& resource : resources) {
+                if(resource.firstPass <= pass && pass <= resource.lastPass) {
+                    live += resource.requirements.size;
+                }
+            }
+            peak = std::max(peak, live);
+        }
+        return peak;
+    }
+}
+
+int main() {
+    VkPhysicalDeviceMemoryProperties memoryProperties = {};
+    memoryProperties.memoryTypeCount = 1;
+    memoryProperties.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    const uint32_t configs[][2] = {{32, 16}, {128, 32}, {512, 64}, {2048, 128}};
+    printf("%9s %6s %12s %12s %12s %8s %12s\n", "resources", "passes", "unaliased", "aliased", "peak live", "saved", "plan time");
+
+    Random random(7);
+    for(auto& config : configs) {
+        uint32_t resourceCount = config[0];
+        uint32_t passCount = config[1];
+        std::vector<VkTransientResourceInfo> resources = makeGraph(resourceCount, passCount, random);
+
+        // repeat small graphs so the timing is not dominated by clock resolution
+        uint32_t repetitions = std::max<uint32_t>(1, 20000 / resourceCount);
+        VkTransientAliasPlan plan;
+        Clock::time_point start = Clock::now();
+        for(uint32_t i = 0; i < repetitions; i++) {
+            planTransientAliasing(resources, memoryProperties, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1024, plan);
+            consume(plan.totalSize());
+        }
+        double planSeconds = secondsSince(start) / repetitions;
+
+        double unaliased = (double)plan.unaliasedSize / MB;
+        double aliased = (double)plan.totalSize() / MB;
+        printf("%9u %6u %9.1f MB %9.1f MB %9.1f MB %7.1f%% %9.3f ms\n", resourceCount, passCount, unaliased, aliased,
+            (double)peakLiveSize(resources, passCount) / MB, 100.0 * (1.0 - aliased / unaliased), planSeconds * 1e3);
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Measures VkUploadService throughput against the stub driver, which completes each submission after a
+// simulated fixed latency plus size / copy bandwidth, executed in submission order like a single transfer queue.
+// Compares batch sizes to show the cost of one submit per upload.
+
+#include "BenchCommon.h"
+#include "StubDriver.h"
+#include "vkh/VkUploadService.h"
+#include <vector>
+#include <stdio.h>
+
+using namespace vkh;
+using namespace vkh_bench;
+
+namespace {
+    const uint32_t UPLOAD_COUNT = 20000;
+    const VkDeviceSize RING_SIZE = 32 * 1024 * 1024;
+    const std::chrono::microseconds SUBMIT_LATENCY(20);
+    const double COPY_BYTES_PER_SECOND = 12e9;
+
+    struct Upload {
+        bool image;
+        VkDeviceSize size;
+    };
+
+    // mostly small buffer updates, some medium buffers and 128x128 RGBA8 texture tiles
+    std::vector<Upload> makeWorkload() {
+        Random random(3);
+        std::vector<Upload> uploads(UPLOAD_COUNT);
+        for(auto& upload : uploads) {
+            uint32_t kind = random.below(10);
+            upload.image = kind == 0;
+            if(upload.image) {
+                upload.size = 128 * 128 * 4;
+            } else if(kind <= 2) {
+                upload.size = 64 * 1024 + random.below(192 * 1024);
+            } else {
+                upload.size = 256 + random.below(16 * 1024);
+            }
+        }
+        return uploads;
+    }
+
+    void run(const std::vector<Upload>& uploads, const std::vector<uint8_t>& source, uint32_t maxCopiesPerBatch) {
+        stub::reset();
+        stub::setRecording(false);
+        stub::setCopyLatency(SUBMIT_LATENCY, COPY_BYTES_PER_SECOND);
+
+        VkPhysicalDeviceMemoryProperties memoryProperties = {};
+        memoryProperties.memoryTypeCount = 1;
+        memoryProperties.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+        VkUploadService service;
+        service.create(stub::makeHandle<VkDevice>(), memoryProperties, stub::makeHandle<VkQueue>(), 0, RING_SIZE, 4, maxCopiesPerBatch, nullptr);
+
+        std::vector<VkBuffer> buffers;
+        for(int i = 0; i < 64; i++) {
+            buffers.push_back(stub::makeHandle<VkBuffer>());
+        }
+        VkImage image = stub::makeHandle<VkImage>();
+
+        VkBufferImageCopy region = {};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent.width = 128;
+        region.imageExtent.height = 128;
+        region.imageExtent.depth = 1;
+
+        Clock::time_point start = Clock::now();
+        VkUploadToken token = 0;
+        VkDeviceSize bytes = 0;
+        for(uint32_t i = 0; i < uploads.size(); i++) {
+            if(uploads[i].image) {
+                // tiles of a 8192x8192 atlas, never overlapping within a batch
+                region.imageOffset.x = (int32_t)(i % 64) * 128;
+                region.imageOffset.y = (int32_t)(i / 64 % 64) * 128;
+                service.uploadImage(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, region, 4, source.data(), uploads[i].size, token);
+            } else {
+                service.uploadBuffer(buffers[i % buffers.size()], (i / buffers.size()) * 256 * 1024, source.data(), uploads[i].size, token);
+            }
+            bytes += uploads[i].size;
+        }
+        service.wait(token, UINT64_MAX);
+        double seconds = secondsSince(start);
+
+        const VkUploadStats& stats = service.getStats();
+        printf("%10u %10.0f %12.0f %8llu %14.1f\n", maxCopiesPerBatch, bytes / seconds / 1e6, stats.uploads / seconds,
+            (unsigned long long)stats.batches, (double)stats.uploads / stats.batches);
+    }
+}
+
+int main() {
+    std::vector<Upload> uploads = makeWorkload();
+    std::vector<uint8_t> source(256 * 1024, 0xAB);
+
+    printf("%u uploads, %llu MB ring, simulated %lld us per submit and %.0f GB/s copies\n", UPLOAD_COUNT,
+        (unsigned long long)(RING_SIZE >> 20), (long long)SUBMIT_LATENCY.count(), COPY_BYTES_PER_SECOND / 1e9);
+    printf("%10s %10s %12s %8s %14s\n", "batch max", "MB/s", "uploads/s", "batches", "uploads/batch");
+    const uint32_t batchSizes[] = {1, 16, 256};
+    for(uint32_t maxCopiesPerBatch : batchSizes) {
+        run(uploads, source, maxCopiesPerBatch);
+    }
+    return 0;
+}
@@ -0,0 +1,545 @@
+//
+// https://github.com/AlexandrSachkov/VulkanUniqueHandle
+//
+// Copyright 2020, Alexandr Sachkov
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef VK_ANY_UNIQUE_HANDLE_H_
+#define VK_ANY_UNIQUE_HANDLE_H_
+
+#include "VkUniqueHandle.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+#include <assert.h>
+
+#ifndef VKH_MAX_HANDLE_CONTEXTS
+#define VKH_MAX_HANDLE_CONTEXTS 256
+#endif
+
+namespace vkh {
+    // Everything required to release a handle: its parent instance/device/pool and allocator
+    struct VkHandleContext {
+        VkInstance instance = VK_NULL_HANDLE;
+        VkDevice device = VK_NULL_HANDLE;
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* allocCallbacks = nullptr;
+    };
+
+    // returned by VkHandleContexts::add() when the table is full
+    static const uint32_t VK_HANDLE_CONTEXT_INVALID = 0xFFFFFFFF;
+
+    // Process-wide table of handle contexts referenced by index from VkAnyUniqueHandle.
+    // Register a context once per instance/device/pool before creating handles that use it,
+    // and remove it once no handle refers to it anymore so the entry can be reused.
+    class VkHandleContexts {
+        public:
+            // thread-safe, returns the index to pass to VkAnyUniqueHandle or VK_HANDLE_CONTEXT_INVALID
+            // if all VKH_MAX_HANDLE_CONTEXTS entries are in use
+            static uint32_t add(const VkHandleContext& context) {
+                Storage& storage = getStorage();
+                std::lock_guard<std::mutex> lock(storage.mutex);
+
+                uint32_t index = storage.freeHead;
+                if(index != VK_HANDLE_CONTEXT_INVALID) {
+                    storage.freeHead = storage.nextFree[index];
+                } else if(storage.count < VKH_MAX_HANDLE_CONTEXTS) {
+                    index = storage.count++;
+                } else {
+                    return VK_HANDLE_CONTEXT_INVALID;
+                }
+                storage.contexts[index] = context;
+                storage.live[index].store(true, std::memory_order_release);
+                return index;
+            }
+
+            // thread-safe, makes the index available to add(); handles still using it must be released first.
+            // Removing an index that is not in use (e.g. a second time) is ignored.
+            static void remove(uint32_t index) {
+                Storage& storage = getStorage();
+                std::lock_guard<std::mutex> lock(storage.mutex);
+
+                assert(index < storage.count && "Invalid handle context");
+                if(index >= storage.count || !storage.live[index].load(std::memory_order_relaxed)) {
+                    return;
+                }
+                storage.live[index].store(false, std::memory_order_release);
+                storage.contexts[index] = VkHandleContext();
+                storage.nextFree[index] = storage.freeHead;
+                storage.freeHead = index;
+            }
+
+            // true between add() and remove() of the index
+            static bool isValid(uint32_t index) {
+                return index < VKH_MAX_HANDLE_CONTEXTS && getStorage().live[index].load(std::memory_order_acquire);
+            }
+
+            // entries are only written by add(), which happens before handles referring to them are created
+            static const VkHandleContext& get(uint32_t index) {
+                return getStorage().contexts[index];
+            }
+
+        private:
+            struct Storage {
+                Storage() {
+                    for(uint32_t i = 0; i < VKH_MAX_HANDLE_CONTEXTS; i++) {
+                        live[i].store(false, std::memory_order_relaxed);
+                    }
+                }
+
+                VkHandleContext contexts[VKH_MAX_HANDLE_CONTEXTS];
+                std::atomic<bool> live[VKH_MAX_HANDLE_CONTEXTS];
+                uint32_t nextFree[VKH_MAX_HANDLE_CONTEXTS];
+                uint32_t count = 0;
+                uint32_t freeHead = VK_HANDLE_CONTEXT_INVALID;
+                std::mutex mutex;
+            };
+
+            static Storage& getStorage() {
+                static Storage storage;
+                return storage;
+            }
+    };
+
+    template<typename T>
+    struct VkObjectTypeTraits;
+
+#define VKH_OBJECT_TYPE_TRAITS(handleType, objectType) \
+    template<> \
+    struct VkObjectTypeTraits<handleType> { \
+        static const VkObjectType type = objectType; \
+    };
+
+    VKH_OBJECT_TYPE_TRAITS(VkInstance, VK_OBJECT_TYPE_INSTANCE)
+    VKH_OBJECT_TYPE_TRAITS(VkPhysicalDevice, VK_OBJECT_TYPE_PHYSICAL_DEVICE)
+    VKH_OBJECT_TYPE_TRAITS(VkDevice, VK_OBJECT_TYPE_DEVICE)
+    VKH_OBJECT_TYPE_TRAITS(VkQueue, VK_OBJECT_TYPE_QUEUE)
+    VKH_OBJECT_TYPE_TRAITS(VkSemaphore, VK_OBJECT_TYPE_SEMAPHORE)
+    VKH_OBJECT_TYPE_TRAITS(VkCommandBuffer, VK_OBJECT_TYPE_COMMAND_BUFFER)
+    VKH_OBJECT_TYPE_TRAITS(VkFence, VK_OBJECT_TYPE_FENCE)
+    VKH_OBJECT_TYPE_TRAITS(VkDeviceMemory, VK_OBJECT_TYPE_DEVICE_MEMORY)
+    VKH_OBJECT_TYPE_TRAITS(VkBuffer, VK_OBJECT_TYPE_BUFFER)
+    VKH_OBJECT_TYPE_TRAITS(VkImage, VK_OBJECT_TYPE_IMAGE)
+    VKH_OBJECT_TYPE_TRAITS(VkEvent, VK_OBJECT_TYPE_EVENT)
+    VKH_OBJECT_TYPE_TRAITS(VkQueryPool, VK_OBJECT_TYPE_QUERY_POOL)
+    VKH_OBJECT_TYPE_TRAITS(VkBufferView, VK_OBJECT_TYPE_BUFFER_VIEW)
+    VKH_OBJECT_TYPE_TRAITS(VkImageView, VK_OBJECT_TYPE_IMAGE_VIEW)
+    VKH_OBJECT_TYPE_TRAITS(VkShaderModule, VK_OBJECT_TYPE_SHADER_MODULE)
+    VKH_OBJECT_TYPE_TRAITS(VkPipelineCache, VK_OBJECT_TYPE_PIPELINE_CACHE)
+    VKH_OBJECT_TYPE_TRAITS(VkPipelineLayout, VK_OBJECT_TYPE_PIPELINE_LAYOUT)
+    VKH_OBJECT_TYPE_TRAITS(VkRenderPass, VK_OBJECT_TYPE_RENDER_PASS)
+    VKH_OBJECT_TYPE_TRAITS(VkPipeline, VK_OBJECT_TYPE_PIPELINE)
+    VKH_OBJECT_TYPE_TRAITS(VkDescriptorSetLayout, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT)
+    VKH_OBJECT_TYPE_TRAITS(VkSampler, VK_OBJECT_TYPE_SAMPLER)
+    VKH_OBJECT_TYPE_TRAITS(VkDescriptorPool, VK_OBJECT_TYPE_DESCRIPTOR_POOL)
+    VKH_OBJECT_TYPE_TRAITS(VkDescriptorSet, VK_OBJECT_TYPE_DESCRIPTOR_SET)
+    VKH_OBJECT_TYPE_TRAITS(VkFramebuffer, VK_OBJECT_TYPE_FRAMEBUFFER)
+    VKH_OBJECT_TYPE_TRAITS(VkCommandPool, VK_OBJECT_TYPE_COMMAND_POOL)
+    VKH_OBJECT_TYPE_TRAITS(VkSamplerYcbcrConversion, VK_OBJECT_TYPE_SAMPLER_YCBCR_CONVERSION)
+    VKH_OBJECT_TYPE_TRAITS(VkDescriptorUpdateTemplate, VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE)
+    VKH_OBJECT_TYPE_TRAITS(VkSurfaceKHR, VK_OBJECT_TYPE_SURFACE_KHR)
+    VKH_OBJECT_TYPE_TRAITS(VkSwapchainKHR, VK_OBJECT_TYPE_SWAPCHAIN_KHR)
+    VKH_OBJECT_TYPE_TRAITS(VkDebugUtilsMessengerEXT, VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT)
+    VKH_OBJECT_TYPE_TRAITS(VkDebugReportCallbackEXT, VK_OBJECT_TYPE_DEBUG_REPORT_CALLBACK_EXT)
+    VKH_OBJECT_TYPE_TRAITS(VkIndirectCommandsLayoutNVX, VK_OBJECT_TYPE_INDIRECT_COMMANDS_LAYOUT_NVX)
+    VKH_OBJECT_TYPE_TRAITS(VkObjectTableNVX, VK_OBJECT_TYPE_OBJECT_TABLE_NVX)
+    VKH_OBJECT_TYPE_TRAITS(VkValidationCacheEXT, VK_OBJECT_TYPE_VALIDATION_CACHE_EXT)
+    VKH_OBJECT_TYPE_TRAITS(VkAccelerationStructureNV, VK_OBJECT_TYPE_ACCELERATION_STRUCTURE_NV)
+
+#undef VKH_OBJECT_TYPE_TRAITS
+
+    // Type-erased unique handle (16 bytes): raw handle, object type and an index into VkHandleContexts.
+    // Meant for mixed deferred-deletion lists; release is dispatched through a static table per object type.
+    class VkAnyUniqueHandle {
+        public:
+            VkAnyUniqueHandle() : _handle(0), _type(VK_OBJECT_TYPE_UNKNOWN), _context(0) {}
+
+            template<typename T>
+            VkAnyUniqueHandle(T handle, uint32_t context)
+                : _handle((uint64_t)handle), _type(VkObjectTypeTraits<T>::type), _context(context) {}
+
+            VkAnyUniqueHandle(uint64_t handle, VkObjectType type, uint32_t context)
+                : _handle(handle), _type(type), _context(context) {}
+
+            VkAnyUniqueHandle(VkAnyUniqueHandle&& other)
+                : _handle(other._handle), _type(other._type), _context(other._context) {
+                other._handle = 0;
+            }
+
+            VkAnyUniqueHandle& operator=(VkAnyUniqueHandle&& other) {
+                release();
+
+                _handle = other._handle;
+                _type = other._type;
+                _context = other._context;
+
+                other._handle = 0;
+
+                return *this;
+            }
+
+            ~VkAnyUniqueHandle() {
+                release();
+            }
+
+            void release() {
+                if(_handle != 0) {
+                    assert(VkHandleContexts::isValid(_context) && "Handle has no valid context");
+                    uint32_t rank = getDestroyRank(_type);
+                    if(rank < DESTROY_TABLE_SIZE && VkHandleContexts::isValid(_context)) {
+                        getDestroyTable()[rank].destroy(VkHandleContexts::get(_context), &_handle, 1);
+                    }
+                    _handle = 0;
+                }
+            }
+
+            uint64_t get() const {
+                return _handle;
+            }
+
+            VkObjectType getType() const {
+                return _type;
+            }
+
+            uint32_t getContext() const {
+                return _context;
+            }
+
+            bool isValid() const {
+                return _handle != 0;
+            }
+
+            // Releases every handle and clears the list. Handles are grouped by object type and context so that
+            // each destroy function runs in a tight loop (and pool frees become one call per pool).
+            // Groups are released children first: command buffers and descriptor sets before their pools,
+            // device objects before the device and instance objects before the instance.
+            static void releaseAll(std::vector<VkAnyUniqueHandle>& handles) {
+                std::vector<ReleaseKey> keys;
+                keys.reserve(handles.size());
+                for(auto& handle : handles) {
+                    assert((handle._handle == 0 || VkHandleContexts::isValid(handle._context)) && "Handle has no valid context");
+                    if(handle._handle != 0 && VkHandleContexts::isValid(handle._context)) {
+                        keys.push_back({handle._type, handle._context, handle._handle});
+                    }
+                    handle._handle = 0;
+                }
+                handles.clear();
+
+                std::sort(keys.begin(), keys.end(), [](const ReleaseKey& a, const ReleaseKey& b){
+                    return a.type != b.type ? a.type < b.type : a.context < b.context;
+                });
+
+                // one group per type and context; the rank is looked up once per type
+                std::vector<uint64_t> sortedHandles(keys.size());
+                std::vector<ReleaseGroup> groups;
+                uint32_t rank = DESTROY_TABLE_SIZE;
+                for(size_t i = 0; i < keys.size(); i++) {
+                    sortedHandles[i] = keys[i].handle;
+                    bool newType = i == 0 || keys[i].type != keys[i - 1].type;
+                    if(newType) {
+                        rank = getDestroyRank(keys[i].type);
+                    }
+                    if(rank == DESTROY_TABLE_SIZE) {
+                        continue;
+                    }
+                    if(newType || keys[i].context != keys[i - 1].context) {
+                        groups.push_back({rank, keys[i].context, (uint32_t)i, 0});
+                    }
+                    groups.back().count++;
+                }
+
+                std::sort(groups.begin(), groups.end(), [](const ReleaseGroup& a, const ReleaseGroup& b){
+                    return a.rank != b.rank ? a.rank < b.rank : a.context < b.context;
+                });
+                for(auto& group : groups) {
+                    getDestroyTable()[group.rank].destroy(VkHandleContexts::get(group.context), &sortedHandles[group.begin], group.count);
+                }
+            }
+
+        private:
+            VkAnyUniqueHandle(const VkAnyUniqueHandle&) = delete;
+            VkAnyUniqueHandle& operator=(const VkAnyUniqueHandle&) = delete;
+
+            typedef void (*DestroyFunction)(const VkHandleContext& context, const uint64_t* handles, uint32_t count);
+
+            struct DestroyEntry {
+                VkObjectType type;
+                DestroyFunction destroy;
+            };
+
+            struct ReleaseKey {
+                VkObjectType type;
+                uint32_t context;
+                uint64_t handle;
+            };
+
+            struct ReleaseGroup {
+                uint32_t rank;
+                uint32_t context;
+                uint32_t begin;
+                uint32_t count;
+            };
+
+            static const uint32_t DESTROY_TABLE_SIZE = 35;
+            static const uint32_t POOL_FREE_BATCH_SIZE = 64;
+
+            // table order is the release order used by releaseAll
+            static const DestroyEntry* getDestroyTable() {
+                static const DestroyEntry table[DESTROY_TABLE_SIZE] = {
+                    {VK_OBJECT_TYPE_COMMAND_BUFFER, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        VkCommandBuffer batch[POOL_FREE_BATCH_SIZE];
+                        for(uint32_t i = 0; i < count; i += POOL_FREE_BATCH_SIZE) {
+                            uint32_t batchCount = count - i < POOL_FREE_BATCH_SIZE ? count - i : POOL_FREE_BATCH_SIZE;
+                            for(uint32_t j = 0; j < batchCount; j++) {
+                                batch[j] = (VkCommandBuffer)handles[i + j];
+                            }
+                            vkFreeCommandBuffers(context.device, context.commandPool, batchCount, batch);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_DESCRIPTOR_SET, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        VkDescriptorSet batch[POOL_FREE_BATCH_SIZE];
+                        for(uint32_t i = 0; i < count; i += POOL_FREE_BATCH_SIZE) {
+                            uint32_t batchCount = count - i < POOL_FREE_BATCH_SIZE ? count - i : POOL_FREE_BATCH_SIZE;
+                            for(uint32_t j = 0; j < batchCount; j++) {
+                                batch[j] = (VkDescriptorSet)handles[i + j];
+                            }
+                            vkFreeDescriptorSets(context.device, context.descriptorPool, batchCount, batch);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_FRAMEBUFFER, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyFramebuffer(context.device, (VkFramebuffer)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_PIPELINE, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyPipeline(context.device, (VkPipeline)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_PIPELINE_LAYOUT, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyPipelineLayout(context.device, (VkPipelineLayout)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_RENDER_PASS, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyRenderPass(context.device, (VkRenderPass)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_PIPELINE_CACHE, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyPipelineCache(context.device, (VkPipelineCache)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_SHADER_MODULE, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyShaderModule(context.device, (VkShaderModule)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_DESCRIPTOR_UPDATE_TEMPLATE, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyDescriptorUpdateTemplate(context.device, (VkDescriptorUpdateTemplate)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyDescriptorSetLayout(context.device, (VkDescriptorSetLayout)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_SAMPLER, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroySampler(context.device, (VkSampler)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_SAMPLER_YCBCR_CONVERSION, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroySamplerYcbcrConversion(context.device, (VkSamplerYcbcrConversion)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_IMAGE_VIEW, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyImageView(context.device, (VkImageView)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_BUFFER_VIEW, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyBufferView(context.device, (VkBufferView)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_ACCELERATION_STRUCTURE_NV, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyAccelerationStructureNV(context.device, (VkAccelerationStructureNV)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_IMAGE, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyImage(context.device, (VkImage)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_BUFFER, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyBuffer(context.device, (VkBuffer)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_DEVICE_MEMORY, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkFreeMemory(context.device, (VkDeviceMemory)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_EVENT, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyEvent(context.device, (VkEvent)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_QUERY_POOL, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyQueryPool(context.device, (VkQueryPool)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_FENCE, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyFence(context.device, (VkFence)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_SEMAPHORE, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroySemaphore(context.device, (VkSemaphore)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_COMMAND_POOL, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyCommandPool(context.device, (VkCommandPool)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_DESCRIPTOR_POOL, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyDescriptorPool(context.device, (VkDescriptorPool)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_INDIRECT_COMMANDS_LAYOUT_NVX, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyIndirectCommandsLayoutNVX(context.device, (VkIndirectCommandsLayoutNVX)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_OBJECT_TABLE_NVX, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyObjectTableNVX(context.device, (VkObjectTableNVX)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_VALIDATION_CACHE_EXT, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyValidationCacheEXT(context.device, (VkValidationCacheEXT)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_SWAPCHAIN_KHR, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroySwapchainKHR(context.device, (VkSwapchainKHR)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_QUEUE, [](const VkHandleContext&, const uint64_t*, uint32_t){
+                        //no release required
+                    }},
+                    {VK_OBJECT_TYPE_DEVICE, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyDevice((VkDevice)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_PHYSICAL_DEVICE, [](const VkHandleContext&, const uint64_t*, uint32_t){
+                        //no release required
+                    }},
+                    {VK_OBJECT_TYPE_SURFACE_KHR, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroySurfaceKHR(context.instance, (VkSurfaceKHR)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_DEBUG_UTILS_MESSENGER_EXT, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        auto destroyDebugMessenger = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(context.instance,"vkDestroyDebugUtilsMessengerEXT");
+                        for(uint32_t i = 0; destroyDebugMessenger != nullptr && i < count; i++) {
+                            destroyDebugMessenger(context.instance, (VkDebugUtilsMessengerEXT)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_DEBUG_REPORT_CALLBACK_EXT, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        auto destroyDebugReportCallback = (PFN_vkDestroyDebugReportCallbackEXT)vkGetInstanceProcAddr(context.instance,"vkDestroyDebugReportCallbackEXT");
+                        for(uint32_t i = 0; destroyDebugReportCallback != nullptr && i < count; i++) {
+                            destroyDebugReportCallback(context.instance, (VkDebugReportCallbackEXT)handles[i], context.allocCallbacks);
+                        }
+                    }},
+                    {VK_OBJECT_TYPE_INSTANCE, [](const VkHandleContext& context, const uint64_t* handles, uint32_t count){
+                        for(uint32_t i = 0; i < count; i++) {
+                            vkDestroyInstance((VkInstance)handles[i], context.allocCallbacks);
+                        }
+                    }}
+                };
+                return table;
+            }
+
+            // core object types are consecutive from zero and resolve through a table built once from the destroy table;
+            // the few extension types fall back to a search
+            static const uint32_t CORE_OBJECT_TYPE_COUNT = VK_OBJECT_TYPE_COMMAND_POOL + 1;
+
+            static uint32_t getDestroyRank(VkObjectType type) {
+                struct CoreRanks {
+                    uint8_t ranks[CORE_OBJECT_TYPE_COUNT];
+
+                    CoreRanks() {
+                        const DestroyEntry* table = getDestroyTable();
+                        for(uint32_t type = 0; type < CORE_OBJECT_TYPE_COUNT; type++) {
+                            ranks[type] = (uint8_t)DESTROY_TABLE_SIZE;
+                        }
+                        for(uint32_t rank = 0; rank < DESTROY_TABLE_SIZE; rank++) {
+                            if((uint32_t)table[rank].type < CORE_OBJECT_TYPE_COUNT) {
+                                ranks[table[rank].type] = (uint8_t)rank;
+                            }
+                        }
+                    }
+                };
+                static const CoreRanks coreRanks;
+
+                uint32_t rank = DESTROY_TABLE_SIZE;
+                if((uint32_t)type < CORE_OBJECT_TYPE_COUNT) {
+                    rank = coreRanks.ranks[type];
+                } else {
+                    const DestroyEntry* table = getDestroyTable();
+                    for(uint32_t i = 0; i < DESTROY_TABLE_SIZE; i++) {
+                        if(table[i].type == type) {
+                            rank = i;
+                            break;
+                        }
+                    }
+                }
+                assert(rank < DESTROY_TABLE_SIZE && "Unsupported handle type");
+                return rank;
+            }
+
+            uint64_t _handle;
+            VkObjectType _type;
+            uint32_t _context;
+    };
+
+    static_assert(sizeof(VkAnyUniqueHandle) == 16, "VkAnyUniqueHandle is expected to be 16 bytes");
+}
+
+#endif //VK_ANY_UNIQUE_HANDLE_H_
@@ -0,0 +1,207 @@
+//
+// https://github.com/AlexandrSachkov/VulkanUniqueHandle
+//
+// Copyright 2020, Alexandr Sachkov
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef VK_FENCE_REACTOR_H_
+#define VK_FENCE_REACTOR_H_
+
+#if !defined(__cpp_impl_coroutine)
+#error "VkFenceReactor.h requires C++20 coroutine support"
+#endif
+
+#include "VkUniqueHandle.h"
+#include <coroutine>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vkh {
+    // Lets coroutines co_await fences without blocking a thread per fence.
+    // A reactor thread waits on all pending fences at once with vkWaitForFences(waitAll = VK_FALSE)
+    // and resumes the coroutines whose fences have signalled on the executor.
+    // The default executor resumes coroutines inline on the reactor thread.
+    class VkFenceReactor {
+        public:
+            typedef std::function<void(std::function<void()>)> Executor;
+
+            class FenceAwaiter {
+                public:
+                    FenceAwaiter(VkFenceReactor* reactor, VkFence fence)
+                        : _reactor(reactor), _fence(fence) {}
+
+                    bool await_ready() {
+                        _result = vkGetFenceStatus(_reactor->_device, _fence);
+                        return _result != VK_NOT_READY;
+                    }
+
+                    // does not suspend if the reactor is already shutting down
+                    bool await_suspend(std::coroutine_handle<> coroutine) {
+                        _coroutine = coroutine;
+                        return _reactor->enqueue(this);
+                    }
+
+                    // VK_SUCCESS once signalled, VK_NOT_READY if the reactor shut down first, otherwise the wait error
+                    VkResult await_resume() {
+                        return _result;
+                    }
+
+                private:
+                    friend class VkFenceReactor;
+
+                    VkFenceReactor* _reactor;
+                    VkFence _fence;
+                    VkResult _result = VK_NOT_READY;
+                    std::coroutine_handle<> _coroutine;
+            };
+
+            VkFenceReactor(VkDevice device)
+                : VkFenceReactor(device, nullptr, 1000000) {}
+
+            // pollTimeoutNs bounds how long newly submitted fences wait before they join the batch
+            VkFenceReactor(VkDevice device, Executor executor, uint64_t pollTimeoutNs)
+                : _device(device), _executor(executor), _pollTimeout(pollTimeoutNs) {
+                if(!_executor) {
+                    _executor = [](std::function<void()> task){
+                        task();
+                    };
+                }
+                _thread = std::thread([this](){
+                    run();
+                });
+            }
+
+            // coroutines still waiting are resumed with VK_NOT_READY
+            ~VkFenceReactor() {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stop = true;
+                }
+                _wakeup.notify_one();
+                _thread.join();
+            }
+
+            FenceAwaiter wait(VkFence fence) {
+                return FenceAwaiter(this, fence);
+            }
+
+            FenceAwaiter wait(VkUniqueHandle<VkFence>& fence) {
+                return FenceAwaiter(this, fence.get());
+            }
+
+        private:
+            VkFenceReactor(const VkFenceReactor&) = delete;
+            VkFenceReactor& operator=(const VkFenceReactor&) = delete;
+
+            // returns false without queueing once the reactor is stopping, since run() no longer drains _submitted
+            bool enqueue(FenceAwaiter* awaiter) {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if(_stop) {
+                        awaiter->_result = VK_NOT_READY;
+                        return false;
+                    }
+                    _submitted.push_back(awaiter);
+                }
+                _wakeup.notify_one();
+                return true;
+            }
+
+            void complete(FenceAwaiter* awaiter, VkResult result) {
+                awaiter->_result = result;
+                std::coroutine_handle<> coroutine = awaiter->_coroutine;
+                _executor([coroutine](){
+                    coroutine.resume();
+                });
+            }
+
+            void run() {
+                // only touched by the reactor thread
+                std::vector<FenceAwaiter*> waiting;
+                std::vector<VkFence> fences;
+
+                while(true) {
+                    {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        if(waiting.empty()) {
+                            _wakeup.wait(lock, [this](){
+                                return _stop || !_submitted.empty();
+                            });
+                        }
+                        if(_stop) {
+                            break;
+                        }
+                        waiting.insert(waiting.end(), _submitted.begin(), _submitted.end());
+                        _submitted.clear();
+                    }
+
+                    fences.clear();
+                    for(auto awaiter : waiting) {
+                        fences.push_back(awaiter->_fence);
+                    }
+
+                    VkResult result = vkWaitForFences(_device, (uint32_t)fences.size(), fences.data(), VK_FALSE, _pollTimeout);
+                    if(result == VK_TIMEOUT) {
+                        continue;
+                    }
+
+                    // vkWaitForFences does not report which fences signalled, so query each one
+                    size_t remaining = 0;
+                    for(auto awaiter : waiting) {
+                        VkResult status = result == VK_SUCCESS ? vkGetFenceStatus(_device, awaiter->_fence) : result;
+                        if(status == VK_NOT_READY) {
+                            waiting[remaining++] = awaiter;
+                        } else {
+                            complete(awaiter, status);
+                        }
+                    }
+                    waiting.resize(remaining);
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    waiting.insert(waiting.end(), _submitted.begin(), _submitted.end());
+                    _submitted.clear();
+                }
+                for(auto awaiter : waiting) {
+                    complete(awaiter, VK_NOT_READY);
+                }
+            }
+
+            VkDevice _device;
+            Executor _executor;
+            uint64_t _pollTimeout;
+
+            std::mutex _mutex;
+            std::condition_variable _wakeup;
+            std::vector<FenceAwaiter*> _submitted;
+            bool _stop = false;
+
+            std::thread _thread;
+    };
+}
+
+#endif //VK_FENCE_REACTOR_H_
@@ -0,0 +1,223 @@
+//
+// https://github.com/AlexandrSachkov/VulkanUniqueHandle
+//
+// Copyright 2020, Alexandr Sachkov
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef VK_HANDLE_SLOT_MAP_H_
+#define VK_HANDLE_SLOT_MAP_H_
+
+#include "VkUniqueHandle.h"
+#include <vector>
+#include <stdint.h>
+#include <assert.h>
+
+namespace vkh {
+    // 32-bit generational id: low VK_HANDLE_ID_INDEX_BITS bits index the slot, the rest hold the slot generation
+    typedef uint32_t VkHandleId;
+
+    static const uint32_t VK_HANDLE_ID_INDEX_BITS = 20;
+    static const uint32_t VK_HANDLE_ID_INDEX_MASK = (1u << VK_HANDLE_ID_INDEX_BITS) - 1;
+    static const uint32_t VK_HANDLE_ID_GENERATION_MASK = (1u << (32 - VK_HANDLE_ID_INDEX_BITS)) - 1;
+    static const VkHandleId VK_NULL_HANDLE_ID = 0;
+
+    // Owns unique handles in dense arrays and hands out generational ids.
+    // Raw handles are kept contiguous (see data()/size()) so they can be iterated or passed to Vulkan directly.
+    // Insert, erase and lookup are O(1); erase moves the last element into the freed dense position.
+    template<typename T>
+    class VkHandleSlotMap {
+        public:
+            VkHandleSlotMap() {}
+
+            VkHandleSlotMap(VkHandleSlotMap&& other) {
+                *this = std::move(other);
+            }
+
+            VkHandleSlotMap& operator=(VkHandleSlotMap&& other) {
+                clear();
+
+                _handles = std::move(other._handles);
+                _owners = std::move(other._owners);
+                _denseToSlot = std::move(other._denseToSlot);
+                _slots = std::move(other._slots);
+                _freeHead = other._freeHead;
+
+                other._freeHead = INVALID_INDEX;
+                return *this;
+            }
+
+            ~VkHandleSlotMap() {
+                clear();
+            }
+
+            // takes ownership of the handle, returns VK_NULL_HANDLE_ID if the map is full
+            VkHandleId insert(VkUniqueHandle<T>&& handle) {
+                uint32_t slotIndex = _freeHead;
+                if(slotIndex != INVALID_INDEX) {
+                    _freeHead = _slots[slotIndex].dense;
+                } else {
+                    if(_slots.size() > VK_HANDLE_ID_INDEX_MASK) {
+                        return VK_NULL_HANDLE_ID;
+                    }
+                    slotIndex = (uint32_t)_slots.size();
+                    _slots.push_back(Slot());
+                }
+
+                Slot& slot = _slots[slotIndex];
+                slot.dense = (uint32_t)_owners.size();
+
+                _handles.push_back(handle.get());
+                _owners.push_back(std::move(handle));
+                _denseToSlot.push_back(slotIndex);
+
+                return makeId(slotIndex, slot.generation);
+            }
+
+            bool contains(VkHandleId id) const {
+                return findSlot(id) != nullptr;
+            }
+
+            // returns VK_NULL_HANDLE for stale or invalid ids
+            T get(VkHandleId id) const {
+                const Slot* slot = findSlot(id);
+                return slot != nullptr ? _handles[slot->dense] : VK_NULL_HANDLE;
+            }
+
+            // releases the handle, returns false for stale or invalid ids
+            bool erase(VkHandleId id) {
+                VkUniqueHandle<T> handle;
+                if(!take(id, handle)) {
+                    return false;
+                }
+                handle.release();
+                return true;
+            }
+
+            // moves the handle out of the map without releasing it, returns false for stale or invalid ids
+            bool take(VkHandleId id, VkUniqueHandle<T>& out) {
+                Slot* slot = findSlot(id);
+                if(slot == nullptr) {
+                    return false;
+                }
+
+                uint32_t slotIndex = id & VK_HANDLE_ID_INDEX_MASK;
+                uint32_t dense = slot->dense;
+                uint32_t last = (uint32_t)_owners.size() - 1;
+
+                out = std::move(_owners[dense]);
+                if(dense != last) {
+                    _handles[dense] = _handles[last];
+                    _owners[dense] = std::move(_owners[last]);
+                    _denseToSlot[dense] = _denseToSlot[last];
+                    _slots[_denseToSlot[dense]].dense = dense;
+                }
+                _handles.pop_back();
+                _owners.pop_back();
+                _denseToSlot.pop_back();
+
+                // bump the generation so outstanding ids become stale; skip 0 so an id is never VK_NULL_HANDLE_ID
+                slot->generation = (slot->generation + 1) & VK_HANDLE_ID_GENERATION_MASK;
+                if(slotIndex == 0 && slot->generation == 0) {
+                    slot->generation = 1;
+                }
+                slot->dense = _freeHead;
+                _freeHead = slotIndex;
+                return true;
+            }
+
+            // releases every handle and invalidates all outstanding ids
+            void clear() {
+                while(!_owners.empty()) {
+                    VkUniqueHandle<T> handle;
+                    take(idAt((uint32_t)_owners.size() - 1), handle);
+                }
+            }
+
+            // id of the handle at a dense position, valid for 0 <= denseIndex < size()
+            VkHandleId idAt(uint32_t denseIndex) const {
+                uint32_t slotIndex = _denseToSlot[denseIndex];
+                return makeId(slotIndex, _slots[slotIndex].generation);
+            }
+
+            const T* data() const {
+                return _handles.data();
+            }
+
+            uint32_t size() const {
+                return (uint32_t)_handles.size();
+            }
+
+            bool empty() const {
+                return _handles.empty();
+            }
+
+            void reserve(uint32_t capacity) {
+                _handles.reserve(capacity);
+                _owners.reserve(capacity);
+                _denseToSlot.reserve(capacity);
+                _slots.reserve(capacity);
+            }
+
+        private:
+            VkHandleSlotMap(const VkHandleSlotMap&) = delete;
+            VkHandleSlotMap& operator=(const VkHandleSlotMap&) = delete;
+
+            static const uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+            struct Slot {
+                // dense index while occupied, next free slot while free
+                uint32_t dense = INVALID_INDEX;
+                // slot 0 starts at generation 1 so that no valid id equals VK_NULL_HANDLE_ID
+                uint32_t generation = 1;
+            };
+
+            static VkHandleId makeId(uint32_t slotIndex, uint32_t generation) {
+                return (generation << VK_HANDLE_ID_INDEX_BITS) | slotIndex;
+            }
+
+            const Slot* findSlot(VkHandleId id) const {
+                uint32_t slotIndex = id & VK_HANDLE_ID_INDEX_MASK;
+                if(slotIndex >= _slots.size()) {
+                    return nullptr;
+                }
+                const Slot& slot = _slots[slotIndex];
+                if(slot.generation != (id >> VK_HANDLE_ID_INDEX_BITS) || slot.dense >= _owners.size()
+                    || _denseToSlot[slot.dense] != slotIndex) {
+                    return nullptr;
+                }
+                return &slot;
+            }
+
+            Slot* findSlot(VkHandleId id) {
+                return const_cast<Slot*>(static_cast<const VkHandleSlotMap*>(this)->findSlot(id));
+            }
+
+            std::vector<T> _handles;
+            std::vector<VkUniqueHandle<T>> _owners;
+            std::vector<uint32_t> _denseToSlot;
+            std::vector<Slot> _slots;
+            uint32_t _freeHead = INVALID_INDEX;
+    };
+}
+
+#endif //VK_HANDLE_SLOT_MAP_H_
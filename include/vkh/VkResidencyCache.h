@@ -0,0 +1,254 @@
+//
+// https://github.com/AlexandrSachkov/VulkanUniqueHandle
+//
+// Copyright 2020, Alexandr Sachkov
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef VK_RESIDENCY_CACHE_H_
+#define VK_RESIDENCY_CACHE_H_
+
+#include "VkUniqueHandle.h"
+#include "VkAnyUniqueHandle.h"
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+namespace vkh {
+    struct VkMemoryBudget {
+        VkDeviceSize budget;
+        VkDeviceSize usage;
+    };
+
+    typedef std::function<VkMemoryBudget()> VkMemoryBudgetSource;
+
+    // Budget source backed by VK_EXT_memory_budget, which must be enabled on the device
+    inline VkMemoryBudgetSource makeMemoryBudgetSource(VkPhysicalDevice physicalDevice, uint32_t heapIndex) {
+        return [physicalDevice, heapIndex](){
+            VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {};
+            budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+            VkPhysicalDeviceMemoryProperties2 memoryProperties = {};
+            memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+            memoryProperties.pNext = &budgetProperties;
+            vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &memoryProperties);
+
+            VkMemoryBudget budget;
+            budget.budget = budgetProperties.heapBudget[heapIndex];
+            budget.usage = budgetProperties.heapUsage[heapIndex];
+            return budget;
+        };
+    }
+
+    struct VkResidencyMetrics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        VkDeviceSize evictedBytes = 0;
+    };
+
+    // Tracks size and last-use frame of resident images/buffers and evicts the least recently used ones
+    // once the memory usage reported by the budget source exceeds targetRatio * budget.
+    // Evicted handles are released framesInFlight frames later so the GPU is no longer using them.
+    // touch() and eviction are O(1). Not thread-safe.
+    class VkResidencyCache {
+        public:
+            VkResidencyCache(VkMemoryBudgetSource budgetSource)
+                : VkResidencyCache(budgetSource, 0.9f, 2) {}
+
+            VkResidencyCache(VkMemoryBudgetSource budgetSource, float targetRatio, uint32_t framesInFlight)
+                : _budgetSource(budgetSource), _targetRatio(targetRatio), _framesInFlight(framesInFlight) {}
+
+            ~VkResidencyCache() {
+                clear();
+            }
+
+            // marks the resource as used this frame; returns false (a miss) if it is not resident
+            bool touch(uint64_t key) {
+                auto it = _entries.find(key);
+                if(it == _entries.end()) {
+                    _metrics.misses++;
+                    return false;
+                }
+
+                _metrics.hits++;
+                it->second->lastUseFrame = _frame;
+                _lru.splice(_lru.begin(), _lru, it->second);
+                return true;
+            }
+
+            bool contains(uint64_t key) const {
+                return _entries.find(key) != _entries.end();
+            }
+
+            // takes ownership of the handles backing the resource (e.g. image and its memory);
+            // a resource already resident under the same key is released through deferred destruction
+            void insert(uint64_t key, VkDeviceSize size, std::vector<VkAnyUniqueHandle>&& handles) {
+                erase(key);
+
+                _lru.push_front(Entry());
+                Entry& entry = _lru.front();
+                entry.key = key;
+                entry.size = size;
+                entry.lastUseFrame = _frame;
+                entry.handles = std::move(handles);
+
+                _entries[key] = _lru.begin();
+                _residentBytes += size;
+            }
+
+            // releases the resource through deferred destruction, returns false if it is not resident
+            bool erase(uint64_t key) {
+                auto it = _entries.find(key);
+                if(it == _entries.end()) {
+                    return false;
+                }
+                retire(it->second);
+                return true;
+            }
+
+            // releases handles retired framesInFlight frames ago, then evicts until usage is back under the target
+            void beginFrame(uint64_t frame) {
+                _frame = frame;
+
+                std::vector<VkAnyUniqueHandle> expired;
+                while(!_pending.empty() && _pending.front().frame + _framesInFlight <= frame) {
+                    PendingRelease& pending = _pending.front();
+                    for(auto& handle : pending.handles) {
+                        expired.push_back(std::move(handle));
+                    }
+                    _pendingBytes -= pending.size;
+                    _pending.pop_front();
+                }
+                VkAnyUniqueHandle::releaseAll(expired);
+
+                trim();
+            }
+
+            // evicts least recently used resources not used this frame while usage exceeds the target
+            void trim() {
+                VkMemoryBudget budget = _budgetSource();
+                VkDeviceSize target = (VkDeviceSize)(budget.budget * _targetRatio);
+                // memory waiting for deferred destruction is still counted by the driver
+                VkDeviceSize usage = budget.usage > _pendingBytes ? budget.usage - _pendingBytes : 0;
+
+                while(usage > target && !_lru.empty() && _lru.back().lastUseFrame < _frame) {
+                    auto it = std::prev(_lru.end());
+                    VkDeviceSize size = it->size;
+
+                    _metrics.evictions++;
+                    _metrics.evictedBytes += size;
+                    retire(it);
+
+                    usage = usage > size ? usage - size : 0;
+                }
+            }
+
+            // releases everything immediately; the GPU must be idle
+            void clear() {
+                std::vector<VkAnyUniqueHandle> handles;
+                for(auto& pending : _pending) {
+                    for(auto& handle : pending.handles) {
+                        handles.push_back(std::move(handle));
+                    }
+                }
+                for(auto& entry : _lru) {
+                    for(auto& handle : entry.handles) {
+                        handles.push_back(std::move(handle));
+                    }
+                }
+                VkAnyUniqueHandle::releaseAll(handles);
+
+                _pending.clear();
+                _lru.clear();
+                _entries.clear();
+                _residentBytes = 0;
+                _pendingBytes = 0;
+            }
+
+            VkDeviceSize getResidentBytes() const {
+                return _residentBytes;
+            }
+
+            VkDeviceSize getPendingReleaseBytes() const {
+                return _pendingBytes;
+            }
+
+            const VkResidencyMetrics& getMetrics() const {
+                return _metrics;
+            }
+
+            void resetMetrics() {
+                _metrics = VkResidencyMetrics();
+            }
+
+        private:
+            VkResidencyCache(const VkResidencyCache&) = delete;
+            VkResidencyCache& operator=(const VkResidencyCache&) = delete;
+
+            struct Entry {
+                uint64_t key = 0;
+                VkDeviceSize size = 0;
+                uint64_t lastUseFrame = 0;
+                std::vector<VkAnyUniqueHandle> handles;
+            };
+
+            struct PendingRelease {
+                uint64_t frame;
+                VkDeviceSize size;
+                std::vector<VkAnyUniqueHandle> handles;
+            };
+
+            void retire(std::list<Entry>::iterator it) {
+                PendingRelease pending;
+                pending.frame = _frame;
+                pending.size = it->size;
+                pending.handles = std::move(it->handles);
+                _pending.push_back(std::move(pending));
+
+                _residentBytes -= it->size;
+                _pendingBytes += it->size;
+                _entries.erase(it->key);
+                _lru.erase(it);
+            }
+
+            VkMemoryBudgetSource _budgetSource;
+            float _targetRatio;
+            uint32_t _framesInFlight;
+            uint64_t _frame = 0;
+
+            // front is the most recently used
+            std::list<Entry> _lru;
+            std::unordered_map<uint64_t, std::list<Entry>::iterator> _entries;
+            std::deque<PendingRelease> _pending;
+
+            VkDeviceSize _residentBytes = 0;
+            VkDeviceSize _pendingBytes = 0;
+            VkResidencyMetrics _metrics;
+    };
+}
+
+#endif //VK_RESIDENCY_CACHE_H_
@@ -0,0 +1,311 @@
+//
+// https://github.com/AlexandrSachkov/VulkanUniqueHandle
+//
+// Copyright 2020, Alexandr Sachkov
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef VK_TRANSIENT_ALIASING_H_
+#define VK_TRANSIENT_ALIASING_H_
+
+#include "VkUniqueHandle.h"
+#include "VkUniqueBoundResource.h"
+#include <algorithm>
+#include <vector>
+#include <stdint.h>
+
+namespace vkh {
+    // Memory requirements of a transient resource and the render graph passes it is alive for (inclusive)
+    struct VkTransientResourceInfo {
+        VkMemoryRequirements requirements;
+        uint32_t firstPass;
+        uint32_t lastPass;
+    };
+
+    struct VkTransientPlacement {
+        uint32_t heap;
+        VkDeviceSize offset;
+    };
+
+    struct VkTransientAliasPlan {
+        // one placement per input resource, in input order
+        std::vector<VkTransientPlacement> placements;
+        std::vector<VkDeviceSize> heapSizes;
+        std::vector<uint32_t> heapMemoryTypes;
+        // memory the resources would need without aliasing
+        VkDeviceSize unaliasedSize = 0;
+
+        VkDeviceSize totalSize() const {
+            VkDeviceSize total = 0;
+            for(auto size : heapSizes) {
+                total += size;
+            }
+            return total;
+        }
+    };
+
+    // Packs resources with non-overlapping pass lifetimes into shared heaps (pure CPU, no Vulkan calls).
+    // Resources get one heap per memory type: the first type allowed by their requirements that has requiredFlags.
+    // Within a heap, resources are placed largest first into the best fitting gap left by resources whose
+    // lifetimes overlap theirs. Offsets are aligned to at least bufferImageGranularity so buffers and
+    // optimal-tiling images may share a heap. Returns false and leaves the plan empty if a resource has
+    // no suitable memory type.
+    inline bool planTransientAliasing(const std::vector<VkTransientResourceInfo>& resources,
+        const VkPhysicalDeviceMemoryProperties& memoryProperties, VkMemoryPropertyFlags requiredFlags,
+        VkDeviceSize bufferImageGranularity, VkTransientAliasPlan& plan) {
+
+        plan.placements.assign(resources.size(), VkTransientPlacement{0, 0});
+        plan.heapSizes.clear();
+        plan.heapMemoryTypes.clear();
+        plan.unaliasedSize = 0;
+
+        for(size_t i = 0; i < resources.size(); i++) {
+            const VkMemoryRequirements& requirements = resources[i].requirements;
+            uint32_t memoryType = VK_MAX_MEMORY_TYPES;
+            for(uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++) {
+                if((requirements.memoryTypeBits & (1u << type))
+                    && (memoryProperties.memoryTypes[type].propertyFlags & requiredFlags) == requiredFlags) {
+                    memoryType = type;
+                    break;
+                }
+            }
+            if(memoryType == VK_MAX_MEMORY_TYPES) {
+                plan = VkTransientAliasPlan();
+                return false;
+            }
+
+            auto heap = std::find(plan.heapMemoryTypes.begin(), plan.heapMemoryTypes.end(), memoryType);
+            plan.placements[i].heap = (uint32_t)(heap - plan.heapMemoryTypes.begin());
+            if(heap == plan.heapMemoryTypes.end()) {
+                plan.heapMemoryTypes.push_back(memoryType);
+                plan.heapSizes.push_back(0);
+            }
+            plan.unaliasedSize += requirements.size;
+        }
+
+        std::vector<uint32_t> order(resources.size());
+        for(uint32_t i = 0; i < (uint32_t)order.size(); i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&resources](uint32_t a, uint32_t b){
+            if(resources[a].requirements.size != resources[b].requirements.size) {
+                return resources[a].requirements.size > resources[b].requirements.size;
+            }
+            return resources[a].firstPass < resources[b].firstPass;
+        });
+
+        struct Range {
+            VkDeviceSize begin;
+            VkDeviceSize end;
+        };
+
+        std::vector<uint32_t> placed;
+        std::vector<Range> occupied;
+        for(uint32_t index : order) {
+            const VkTransientResourceInfo& resource = resources[index];
+            VkTransientPlacement& placement = plan.placements[index];
+            VkDeviceSize size = resource.requirements.size;
+            VkDeviceSize alignment = std::max<VkDeviceSize>(std::max<VkDeviceSize>(resource.requirements.alignment, bufferImageGranularity), 1);
+
+            // memory ranges used by already placed resources whose lifetimes overlap this one
+            occupied.clear();
+            for(uint32_t other : placed) {
+                const VkTransientResourceInfo& otherResource = resources[other];
+                const VkTransientPlacement& otherPlacement = plan.placements[other];
+                if(otherPlacement.heap == placement.heap
+                    && otherResource.firstPass <= resource.lastPass && resource.firstPass <= otherResource.lastPass) {
+                    occupied.push_back({otherPlacement.offset, otherPlacement.offset + otherResource.requirements.size});
+                }
+            }
+            std::sort(occupied.begin(), occupied.end(), [](const Range& a, const Range& b){
+                return a.begin < b.begin;
+            });
+
+            // best fit: the smallest gap between occupied ranges that can hold the resource, otherwise the end
+            VkDeviceSize cursor = 0;
+            VkDeviceSize bestOffset = 0;
+            VkDeviceSize bestGap = ~(VkDeviceSize)0;
+            for(const Range& range : occupied) {
+                VkDeviceSize offset = (cursor + alignment - 1) / alignment * alignment;
+                if(range.begin > cursor && offset + size <= range.begin && range.begin - cursor < bestGap) {
+                    bestGap = range.begin - cursor;
+                    bestOffset = offset;
+                }
+                cursor = std::max(cursor, range.end);
+            }
+            if(bestGap == ~(VkDeviceSize)0) {
+                bestOffset = (cursor + alignment - 1) / alignment * alignment;
+            }
+
+            placement.offset = bestOffset;
+            plan.heapSizes[placement.heap] = std::max(plan.heapSizes[placement.heap], bestOffset + size);
+            placed.push_back(index);
+        }
+        return true;
+    }
+
+    struct VkTransientImageInfo {
+        VkImageCreateInfo createInfo;
+        uint32_t firstPass;
+        uint32_t lastPass;
+    };
+
+    struct VkTransientBufferInfo {
+        VkBufferCreateInfo createInfo;
+        uint32_t firstPass;
+        uint32_t lastPass;
+    };
+
+    // Creates transient images and buffers and binds them into a few shared, aliased VkDeviceMemory heaps.
+    // Resources are released before the heaps they alias.
+    class VkTransientResourceSet {
+        public:
+            VkTransientResourceSet() {}
+
+            VkTransientResourceSet(VkTransientResourceSet&& other) {
+                *this = std::move(other);
+            }
+
+            VkTransientResourceSet& operator=(VkTransientResourceSet&& other) {
+                release();
+
+                _heaps = std::move(other._heaps);
+                _images = std::move(other._images);
+                _buffers = std::move(other._buffers);
+                _plan = std::move(other._plan);
+
+                return *this;
+            }
+
+            ~VkTransientResourceSet() {
+                release();
+            }
+
+            // images come first in the plan, followed by buffers
+            VkResult create(VkDevice device, const VkPhysicalDeviceMemoryProperties& memoryProperties, VkDeviceSize bufferImageGranularity,
+                const std::vector<VkTransientImageInfo>& images, const std::vector<VkTransientBufferInfo>& buffers,
+                const VkAllocationCallbacks* allocCallbacks = nullptr) {
+
+                release();
+
+                std::vector<VkUniqueHandle<VkImage>> imageHandles;
+                std::vector<VkUniqueHandle<VkBuffer>> bufferHandles;
+                std::vector<VkTransientResourceInfo> resources;
+
+                for(auto& image : images) {
+                    imageHandles.push_back(VkUniqueHandle<VkImage>(VK_NULL_HANDLE, device, allocCallbacks));
+                    VkResult result = vkCreateImage(device, &image.createInfo, allocCallbacks, &imageHandles.back().get());
+                    if(result != VK_SUCCESS) {
+                        return result;
+                    }
+
+                    VkTransientResourceInfo resource = {};
+                    vkGetImageMemoryRequirements(device, imageHandles.back().get(), &resource.requirements);
+                    resource.firstPass = image.firstPass;
+                    resource.lastPass = image.lastPass;
+                    resources.push_back(resource);
+                }
+
+                for(auto& buffer : buffers) {
+                    bufferHandles.push_back(VkUniqueHandle<VkBuffer>(VK_NULL_HANDLE, device, allocCallbacks));
+                    VkResult result = vkCreateBuffer(device, &buffer.createInfo, allocCallbacks, &bufferHandles.back().get());
+                    if(result != VK_SUCCESS) {
+                        return result;
+                    }
+
+                    VkTransientResourceInfo resource = {};
+                    vkGetBufferMemoryRequirements(device, bufferHandles.back().get(), &resource.requirements);
+                    resource.firstPass = buffer.firstPass;
+                    resource.lastPass = buffer.lastPass;
+                    resources.push_back(resource);
+                }
+
+                if(!planTransientAliasing(resources, memoryProperties, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, bufferImageGranularity, _plan)) {
+                    release();
+                    return VK_ERROR_FEATURE_NOT_PRESENT;
+                }
+
+                for(size_t i = 0; i < _plan.heapSizes.size(); i++) {
+                    VkMemoryAllocateInfo allocInfo = {};
+                    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+                    allocInfo.allocationSize = _plan.heapSizes[i];
+                    allocInfo.memoryTypeIndex = _plan.heapMemoryTypes[i];
+
+                    _heaps.push_back(VkUniqueHandle<VkDeviceMemory>(VK_NULL_HANDLE, device, allocCallbacks));
+                    VkResult result = vkAllocateMemory(device, &allocInfo, allocCallbacks, &_heaps.back().get());
+                    if(result != VK_SUCCESS) {
+                        release();
+                        return result;
+                    }
+                }
+
+                VkBatchMemoryBinder binder(device);
+                for(size_t i = 0; i < imageHandles.size(); i++) {
+                    const VkTransientPlacement& placement = _plan.placements[i];
+                    _images.push_back(VkUniqueBoundImage(std::move(imageHandles[i]), _heaps[placement.heap].get(), placement.offset, nullptr));
+                    binder.add(_images.back());
+                }
+                for(size_t i = 0; i < bufferHandles.size(); i++) {
+                    const VkTransientPlacement& placement = _plan.placements[imageHandles.size() + i];
+                    _buffers.push_back(VkUniqueBoundBuffer(std::move(bufferHandles[i]), _heaps[placement.heap].get(), placement.offset, nullptr));
+                    binder.add(_buffers.back());
+                }
+
+                VkResult result = binder.submit();
+                if(result != VK_SUCCESS) {
+                    release();
+                }
+                return result;
+            }
+
+            // also clears the plan, so getPlan() is empty after release() or a failed create()
+            void release() {
+                _images.clear();
+                _buffers.clear();
+                _heaps.clear();
+                _plan = VkTransientAliasPlan();
+            }
+
+            VkUniqueBoundImage& getImage(uint32_t index) {
+                return _images[index];
+            }
+
+            VkUniqueBoundBuffer& getBuffer(uint32_t index) {
+                return _buffers[index];
+            }
+
+            const VkTransientAliasPlan& getPlan() const {
+                return _plan;
+            }
+
+        private:
+            VkTransientResourceSet(const VkTransientResourceSet&) = delete;
+            VkTransientResourceSet& operator=(const VkTransientResourceSet&) = delete;
+
+            std::vector<VkUniqueHandle<VkDeviceMemory>> _heaps;
+            std::vector<VkUniqueBoundImage> _images;
+            std::vector<VkUniqueBoundBuffer> _buffers;
+            VkTransientAliasPlan _plan;
+    };
+}
+
+#endif //VK_TRANSIENT_ALIASING_H_
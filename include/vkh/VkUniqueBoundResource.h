@@ -0,0 +1,180 @@
+//
+// https://github.com/AlexandrSachkov/VulkanUniqueHandle
+//
+// Copyright 2020, Alexandr Sachkov
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef VK_UNIQUE_BOUND_RESOURCE_H_
+#define VK_UNIQUE_BOUND_RESOURCE_H_
+
+#include "VkUniqueHandle.h"
+#include <functional>
+#include <vector>
+
+namespace vkh {
+    // Owns a buffer or image together with the memory it is bound to.
+    // The memory is either a dedicated VkDeviceMemory owned by this object or a sub-allocation
+    // owned by an external allocator, returned through a callback.
+    // The resource is always released before its memory.
+    template<typename T>
+    class VkUniqueBoundResource {
+        public:
+            VkUniqueBoundResource() {}
+
+            VkUniqueBoundResource(VkUniqueHandle<T>&& resource, VkUniqueHandle<VkDeviceMemory>&& memory)
+                : VkUniqueBoundResource(std::move(resource), std::move(memory), 0) {}
+
+            VkUniqueBoundResource(VkUniqueHandle<T>&& resource, VkUniqueHandle<VkDeviceMemory>&& memory, VkDeviceSize offset)
+                : _memory(std::move(memory)), _resource(std::move(resource)), _offset(offset) {
+                _memoryHandle = _memory.get();
+            }
+
+            // sub-allocation: releaseAllocation is called once the resource has been destroyed
+            VkUniqueBoundResource(VkUniqueHandle<T>&& resource, VkDeviceMemory memory, VkDeviceSize offset, std::function<void()> releaseAllocation)
+                : _resource(std::move(resource)), _memoryHandle(memory), _offset(offset), _releaseAllocation(releaseAllocation) {}
+
+            VkUniqueBoundResource(VkUniqueBoundResource&& other) {
+                *this = std::move(other);
+            }
+
+            VkUniqueBoundResource& operator=(VkUniqueBoundResource&& other) {
+                release();
+
+                _memory = std::move(other._memory);
+                _resource = std::move(other._resource);
+                _memoryHandle = other._memoryHandle;
+                _offset = other._offset;
+                _releaseAllocation = std::move(other._releaseAllocation);
+
+                other._memoryHandle = VK_NULL_HANDLE;
+                other._offset = 0;
+                other._releaseAllocation = nullptr;
+
+                return *this;
+            }
+
+            ~VkUniqueBoundResource() {
+                release();
+            }
+
+            void release() {
+                _resource.release();
+                _memory.release();
+                if(_releaseAllocation) {
+                    std::function<void()> releaseAllocation = std::move(_releaseAllocation);
+                    _releaseAllocation = nullptr;
+                    releaseAllocation();
+                }
+                _memoryHandle = VK_NULL_HANDLE;
+                _offset = 0;
+            }
+
+            T& get() {
+                return _resource.get();
+            }
+
+            VkDeviceMemory getMemory() const {
+                return _memoryHandle;
+            }
+
+            VkDeviceSize getOffset() const {
+                return _offset;
+            }
+
+            bool isValid() {
+                return _resource.isValid();
+            }
+
+        private:
+            VkUniqueBoundResource(const VkUniqueBoundResource&) = delete;
+            VkUniqueBoundResource& operator=(const VkUniqueBoundResource&) = delete;
+
+            // declared before the resource so that it is also destroyed after it
+            VkUniqueHandle<VkDeviceMemory> _memory;
+            VkUniqueHandle<T> _resource;
+            VkDeviceMemory _memoryHandle = VK_NULL_HANDLE;
+            VkDeviceSize _offset = 0;
+            std::function<void()> _releaseAllocation;
+    };
+
+    typedef VkUniqueBoundResource<VkBuffer> VkUniqueBoundBuffer;
+    typedef VkUniqueBoundResource<VkImage> VkUniqueBoundImage;
+
+    // Collects pending memory binds and submits them with one vkBindBufferMemory2 and one vkBindImageMemory2 call.
+    // Raw handles are copied when a bind is added; the resources and any pNext chain passed to add()
+    // must stay alive until submit() returns.
+    class VkBatchMemoryBinder {
+        public:
+            VkBatchMemoryBinder(VkDevice device) : _device(device) {}
+
+            void add(VkUniqueBoundBuffer& buffer, const void* pNext = nullptr) {
+                VkBindBufferMemoryInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_INFO;
+                info.pNext = pNext;
+                info.buffer = buffer.get();
+                info.memory = buffer.getMemory();
+                info.memoryOffset = buffer.getOffset();
+                _bufferBinds.push_back(info);
+            }
+
+            void add(VkUniqueBoundImage& image, const void* pNext = nullptr) {
+                VkBindImageMemoryInfo info = {};
+                info.sType = VK_STRUCTURE_TYPE_BIND_IMAGE_MEMORY_INFO;
+                info.pNext = pNext;
+                info.image = image.get();
+                info.memory = image.getMemory();
+                info.memoryOffset = image.getOffset();
+                _imageBinds.push_back(info);
+            }
+
+            uint32_t pendingCount() const {
+                return (uint32_t)(_bufferBinds.size() + _imageBinds.size());
+            }
+
+            // binds everything collected so far; the image binds are attempted even if the buffer binds fail.
+            // Returns the first error; pending binds are cleared either way, since which binds of a failed call
+            // took effect is undefined and the resources must be recreated.
+            VkResult submit() {
+                VkResult result = VK_SUCCESS;
+                if(!_bufferBinds.empty()) {
+                    result = vkBindBufferMemory2(_device, (uint32_t)_bufferBinds.size(), _bufferBinds.data());
+                }
+                if(!_imageBinds.empty()) {
+                    VkResult imageResult = vkBindImageMemory2(_device, (uint32_t)_imageBinds.size(), _imageBinds.data());
+                    if(result == VK_SUCCESS) {
+                        result = imageResult;
+                    }
+                }
+                _bufferBinds.clear();
+                _imageBinds.clear();
+                return result;
+            }
+
+        private:
+            VkDevice _device;
+            std::vector<VkBindBufferMemoryInfo> _bufferBinds;
+            std::vector<VkBindImageMemoryInfo> _imageBinds;
+    };
+}
+
+#endif //VK_UNIQUE_BOUND_RESOURCE_H_
@@ -29,7 +29,11 @@
 
 #include "vulkan/vulkan.h"
 #include <functional>
+#include <atomic>
+#include <mutex>
+#include <vector>
 #include <assert.h>
+#include <stdint.h>
 
 namespace vkh {
     template<typename T>
@@ -102,6 +106,178 @@ namespace vkh {
             }
     };
 
+    // Collects handles released on any thread and frees them in a single batched call on the thread that owns the pool.
+    // Vulkan requires external synchronization of the parent pool when freeing, so only the owning thread may call drain().
+    // push() may be called from any thread and is lock-free and allocation-free while the ring has room:
+    // it claims a slot of a bounded ring sized by the owner (rounded up to a power of two) with a CAS on the tail.
+    // Once the ring is full, handles go to an overflow list guarded by a mutex until the next drain().
+    template<typename T>
+    class VkPoolFreeQueueBase {
+        public:
+            VkPoolFreeQueueBase(std::function<void(uint32_t, const T*)> freeCallback, uint32_t capacity) 
+                : _cells(roundUpToPowerOfTwo(capacity)), _mask(_cells.size() - 1), _head(0), _tail(0), _overflowed(false), _free(freeCallback) {
+                for(size_t i = 0; i < _cells.size(); i++) {
+                    _cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+                _batch.reserve(_cells.size());
+            }
+
+            ~VkPoolFreeQueueBase() {
+                drain();
+            }
+
+            void push(T handle) {
+                size_t pos = _tail.load(std::memory_order_relaxed);
+                while(true) {
+                    Cell& cell = _cells[pos & _mask];
+                    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                    intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+                    if(diff == 0) {
+                        if(_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            cell.handle = handle;
+                            cell.sequence.store(pos + 1, std::memory_order_release);
+                            return;
+                        }
+                    } else if(diff < 0) {
+                        // ring is full until the owner drains it
+                        std::lock_guard<std::mutex> lock(_overflowMutex);
+                        _overflow.push_back(handle);
+                        _overflowed.store(true, std::memory_order_release);
+                        return;
+                    } else {
+                        pos = _tail.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            // frees all queued handles with one call, returns the number of handles freed
+            uint32_t drain() {
+                collect();
+                if(_batch.empty()) {
+                    return 0;
+                }
+                _free((uint32_t)_batch.size(), _batch.data());
+                return (uint32_t)_batch.size();
+            }
+
+            // drops all queued handles without freeing them (e.g. after a pool reset already freed them)
+            void discard() {
+                collect();
+            }
+
+            uint32_t capacity() const {
+                return (uint32_t)_cells.size();
+            }
+
+        private:
+            VkPoolFreeQueueBase(const VkPoolFreeQueueBase<T>&) = delete;
+            VkPoolFreeQueueBase& operator=(const VkPoolFreeQueueBase<T>&) = delete;
+
+            struct Cell {
+                std::atomic<size_t> sequence;
+                T handle;
+            };
+
+            static size_t roundUpToPowerOfTwo(uint32_t value) {
+                size_t size = 1;
+                while(size < value) {
+                    size <<= 1;
+                }
+                return size;
+            }
+
+            // moves every published handle into _batch; slots claimed but not yet written are picked up next time
+            void collect() {
+                _batch.clear();
+                while(true) {
+                    Cell& cell = _cells[_head & _mask];
+                    if(cell.sequence.load(std::memory_order_acquire) != _head + 1) {
+                        break;
+                    }
+                    _batch.push_back(cell.handle);
+                    cell.sequence.store(_head + _cells.size(), std::memory_order_release);
+                    _head++;
+                }
+
+                if(_overflowed.exchange(false, std::memory_order_acquire)) {
+                    std::lock_guard<std::mutex> lock(_overflowMutex);
+                    _batch.insert(_batch.end(), _overflow.begin(), _overflow.end());
+                    _overflow.clear();
+                }
+            }
+
+            std::vector<Cell> _cells;
+            size_t _mask;
+            // only touched by the owning thread
+            size_t _head;
+            std::atomic<size_t> _tail;
+
+            std::atomic<bool> _overflowed;
+            std::mutex _overflowMutex;
+            std::vector<T> _overflow;
+
+            std::function<void(uint32_t, const T*)> _free;
+            std::vector<T> _batch;
+    };
+
+    template <typename T>
+    class VkPoolFreeQueue;
+
+    template <>
+    class VkPoolFreeQueue<VkCommandBuffer> : public VkPoolFreeQueueBase<VkCommandBuffer> {
+        public:
+            VkPoolFreeQueue(VkDevice device, VkCommandPool pool) 
+                : VkPoolFreeQueue(device, pool, 1024) {}
+
+            // capacity bounds the handles queued between drains before push() falls back to the locked overflow list
+            VkPoolFreeQueue(VkDevice device, VkCommandPool pool, uint32_t capacity) 
+                : VkPoolFreeQueueBase<VkCommandBuffer>([device, pool](uint32_t count, const VkCommandBuffer* handles){
+                    vkFreeCommandBuffers(device, pool, count, handles);
+                }, capacity), _device(device), _pool(pool) {}
+
+            VkResult allocate(const VkCommandBufferAllocateInfo& allocInfo, VkCommandBuffer* handles) {
+                drain();
+                return vkAllocateCommandBuffers(_device, &allocInfo, handles);
+            }
+
+            VkResult reset(VkCommandPoolResetFlags flags) {
+                drain();
+                return vkResetCommandPool(_device, _pool, flags);
+            }
+
+        private:
+            VkDevice _device;
+            VkCommandPool _pool;
+    };
+
+    template <>
+    class VkPoolFreeQueue<VkDescriptorSet> : public VkPoolFreeQueueBase<VkDescriptorSet> {
+        public:
+            VkPoolFreeQueue(VkDevice device, VkDescriptorPool pool) 
+                : VkPoolFreeQueue(device, pool, 1024) {}
+
+            // capacity bounds the handles queued between drains before push() falls back to the locked overflow list
+            VkPoolFreeQueue(VkDevice device, VkDescriptorPool pool, uint32_t capacity) 
+                : VkPoolFreeQueueBase<VkDescriptorSet>([device, pool](uint32_t count, const VkDescriptorSet* handles){
+                    vkFreeDescriptorSets(device, pool, count, handles);
+                }, capacity), _device(device), _pool(pool) {}
+
+            VkResult allocate(const VkDescriptorSetAllocateInfo& allocInfo, VkDescriptorSet* handles) {
+                drain();
+                return vkAllocateDescriptorSets(_device, &allocInfo, handles);
+            }
+
+            VkResult reset(VkDescriptorPoolResetFlags flags) {
+                // resetting the pool frees every set allocated from it
+                discard();
+                return vkResetDescriptorPool(_device, _pool, flags);
+            }
+
+        private:
+            VkDevice _device;
+            VkDescriptorPool _pool;
+    };
+
     template <>
     class VkUniqueHandle<VkInstance> : public VkUniqueHandleBase<VkInstance> {
         public:
@@ -211,6 +387,12 @@ namespace vkh {
                     vkFreeCommandBuffers(device, pool, 1, &handle);
                 }) {}
 
+            // release is deferred to the queue and performed when the pool owner drains it; the queue must outlive the handle
+            VkUniqueHandle(VkCommandBuffer handle, VkPoolFreeQueue<VkCommandBuffer>* freeQueue) 
+                : VkUniqueHandleBase<VkCommandBuffer>(handle, [freeQueue](VkCommandBuffer handle){
+                    freeQueue->push(handle);
+                }) {}
+
             VkUniqueHandle(VkUniqueHandle&& other) : VkUniqueHandleBase<VkCommandBuffer>(std::move(other)) {}
 
             VkUniqueHandle& operator=(VkUniqueHandle&& other){
@@ -565,6 +747,12 @@ namespace vkh {
                     vkFreeDescriptorSets(device, pool, 1, &handle);
                 }) {}
 
+            // release is deferred to the queue and performed when the pool owner drains it; the queue must outlive the handle
+            VkUniqueHandle(VkDescriptorSet handle, VkPoolFreeQueue<VkDescriptorSet>* freeQueue) 
+                : VkUniqueHandleBase<VkDescriptorSet>(handle, [freeQueue](VkDescriptorSet handle){
+                    freeQueue->push(handle);
+                }) {}
+
             VkUniqueHandle(VkUniqueHandle&& other) : VkUniqueHandleBase<VkDescriptorSet>(std::move(other)) {}
 
             VkUniqueHandle& operator=(VkUniqueHandle&& other){
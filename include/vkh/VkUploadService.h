@@ -0,0 +1,622 @@
+//
+// https://github.com/AlexandrSachkov/VulkanUniqueHandle
+//
+// Copyright 2020, Alexandr Sachkov
+//
+// The MIT License (http://www.opensource.org/licenses/mit-license.php)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef VK_UPLOAD_SERVICE_H_
+#define VK_UPLOAD_SERVICE_H_
+
+#include "VkUniqueHandle.h"
+#include "VkUniqueBoundResource.h"
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <stdint.h>
+#include <string.h>
+
+namespace vkh {
+    // Timeline semaphore value signalled once the upload has completed on the transfer queue
+    typedef uint64_t VkUploadToken;
+
+    struct VkUploadStats {
+        uint64_t uploads = 0;
+        uint64_t bytes = 0;
+        uint64_t batches = 0;
+    };
+
+    // Uploads buffer and image data through a persistently mapped staging ring on a dedicated transfer queue.
+    // Uploads are merged into one command buffer per batch (copies to the same destination share a single
+    // copy command) and each batch signals the next value of a timeline semaphore. Copies whose destination
+    // ranges overlap an earlier copy in the batch are recorded after a transfer barrier, so the last upload wins.
+    // Staging space is reclaimed once the semaphore reaches the value of the batch that used it.
+    // Destination images must already be in dstLayout; queue family ownership transfers and waiting on
+    // getTimelineSemaphore() from other queues are left to the caller. Not thread-safe.
+    class VkUploadService {
+        public:
+            VkUploadService() {}
+
+            ~VkUploadService() {
+                release();
+            }
+
+            VkResult create(VkDevice device, const VkPhysicalDeviceMemoryProperties& memoryProperties,
+                VkQueue transferQueue, uint32_t transferQueueFamily, VkDeviceSize ringSize) {
+                return create(device, memoryProperties, transferQueue, transferQueueFamily, ringSize, 1, 256, nullptr);
+            }
+
+            // optimalBufferCopyOffsetAlignment comes from VkPhysicalDeviceLimits; every staging offset is aligned to it
+            VkResult create(VkDevice device, const VkPhysicalDeviceMemoryProperties& memoryProperties,
+                VkQueue transferQueue, uint32_t transferQueueFamily, VkDeviceSize ringSize,
+                VkDeviceSize optimalBufferCopyOffsetAlignment, uint32_t maxCopiesPerBatch, const VkAllocationCallbacks* allocCallbacks) {
+
+                release();
+
+                _device = device;
+                _queue = transferQueue;
+                _copyOffsetAlignment = std::max<VkDeviceSize>(optimalBufferCopyOffsetAlignment, 1);
+                _maxCopiesPerBatch = maxCopiesPerBatch;
+
+                VkSemaphoreTypeCreateInfo semaphoreTypeInfo = {};
+                semaphoreTypeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+                semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+                semaphoreTypeInfo.initialValue = 0;
+
+                VkSemaphoreCreateInfo semaphoreInfo = {};
+                semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+                semaphoreInfo.pNext = &semaphoreTypeInfo;
+
+                _semaphore = VkUniqueHandle<VkSemaphore>(VK_NULL_HANDLE, device, allocCallbacks);
+                VkResult result = vkCreateSemaphore(device, &semaphoreInfo, allocCallbacks, &_semaphore.get());
+                if(result != VK_SUCCESS) {
+                    release();
+                    return result;
+                }
+
+                VkCommandPoolCreateInfo poolInfo = {};
+                poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+                poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+                poolInfo.queueFamilyIndex = transferQueueFamily;
+
+                _commandPool = VkUniqueHandle<VkCommandPool>(VK_NULL_HANDLE, device, allocCallbacks);
+                result = vkCreateCommandPool(device, &poolInfo, allocCallbacks, &_commandPool.get());
+                if(result != VK_SUCCESS) {
+                    release();
+                    return result;
+                }
+
+                VkBufferCreateInfo bufferInfo = {};
+                bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+                bufferInfo.size = ringSize;
+                bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+                bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+                VkUniqueHandle<VkBuffer> buffer(VK_NULL_HANDLE, device, allocCallbacks);
+                result = vkCreateBuffer(device, &bufferInfo, allocCallbacks, &buffer.get());
+                if(result != VK_SUCCESS) {
+                    release();
+                    return result;
+                }
+
+                VkMemoryRequirements requirements;
+                vkGetBufferMemoryRequirements(device, buffer.get(), &requirements);
+
+                VkMemoryPropertyFlags requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+                VkMemoryAllocateInfo allocInfo = {};
+                allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+                allocInfo.allocationSize = requirements.size;
+                allocInfo.memoryTypeIndex = VK_MAX_MEMORY_TYPES;
+                for(uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++) {
+                    if((requirements.memoryTypeBits & (1u << type))
+                        && (memoryProperties.memoryTypes[type].propertyFlags & requiredFlags) == requiredFlags) {
+                        allocInfo.memoryTypeIndex = type;
+                        break;
+                    }
+                }
+                if(allocInfo.memoryTypeIndex == VK_MAX_MEMORY_TYPES) {
+                    release();
+                    return VK_ERROR_FEATURE_NOT_PRESENT;
+                }
+
+                VkUniqueHandle<VkDeviceMemory> memory(VK_NULL_HANDLE, device, allocCallbacks);
+                result = vkAllocateMemory(device, &allocInfo, allocCallbacks, &memory.get());
+                if(result == VK_SUCCESS) {
+                    result = vkBindBufferMemory(device, buffer.get(), memory.get(), 0);
+                }
+                void* mapped = nullptr;
+                if(result == VK_SUCCESS) {
+                    result = vkMapMemory(device, memory.get(), 0, VK_WHOLE_SIZE, 0, &mapped);
+                }
+                if(result != VK_SUCCESS) {
+                    release();
+                    return result;
+                }
+
+                // vkFreeMemory implicitly unmaps the ring
+                _staging = VkUniqueBoundBuffer(std::move(buffer), std::move(memory));
+                _mapped = (uint8_t*)mapped;
+                _ringSize = ringSize;
+                return VK_SUCCESS;
+            }
+
+            // waits for all submitted uploads, then releases every owned object
+            void release() {
+                if(_semaphore.isValid() && _submittedValue > 0) {
+                    waitValue(_submittedValue, UINT64_MAX);
+                }
+
+                _commandBuffers.clear();
+                _freeCommandBuffers.clear();
+                _commandPool.release();
+                _staging.release();
+                _semaphore.release();
+
+                _inflight.clear();
+                _bufferCopies.clear();
+                _imageCopies.clear();
+                _pendingBytes = 0;
+                _mapped = nullptr;
+                _ringSize = 0;
+                _head = 0;
+                _tail = 0;
+                _submittedValue = 0;
+            }
+
+            // returns VK_ERROR_UNKNOWN for empty uploads; if the batch becomes full and its submission fails,
+            // the error is returned but the upload stays queued and token remains valid for the retry
+            VkResult uploadBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size, VkUploadToken& token) {
+                VkDeviceSize stagingOffset;
+                VkResult result = stage(data, size, _copyOffsetAlignment, stagingOffset);
+                if(result != VK_SUCCESS) {
+                    return result;
+                }
+
+                PendingBufferCopy copy;
+                copy.dst = dst;
+                copy.region.srcOffset = stagingOffset;
+                copy.region.dstOffset = dstOffset;
+                copy.region.size = size;
+                _bufferCopies.push_back(copy);
+
+                token = _submittedValue + 1;
+                return flushIfFull();
+            }
+
+            // region.bufferOffset is ignored and set to the staging location; dst must be in dstLayout.
+            // texelBlockSize is the size in bytes of a texel (or compressed block) of the copied aspect,
+            // the staging offset is aligned to a multiple of it and of 4 as vkCmdCopyBufferToImage requires
+            VkResult uploadImage(VkImage dst, VkImageLayout dstLayout, const VkBufferImageCopy& region, uint32_t texelBlockSize,
+                const void* data, VkDeviceSize size, VkUploadToken& token) {
+                if(texelBlockSize == 0) {
+                    return VK_ERROR_UNKNOWN;
+                }
+
+                VkDeviceSize alignment = lcm(lcm(texelBlockSize, 4), _copyOffsetAlignment);
+                VkDeviceSize stagingOffset;
+                VkResult result = stage(data, size, alignment, stagingOffset);
+                if(result != VK_SUCCESS) {
+                    return result;
+                }
+
+                PendingImageCopy copy;
+                copy.dst = dst;
+                copy.layout = dstLayout;
+                copy.region = region;
+                copy.region.bufferOffset = stagingOffset;
+                _imageCopies.push_back(copy);
+
+                token = _submittedValue + 1;
+                return flushIfFull();
+            }
+
+            // records all pending uploads into one command buffer and submits it.
+            // On failure the uploads stay pending (their tokens remain valid) and the next flush() retries them.
+            VkResult flush() {
+                if(_bufferCopies.empty() && _imageCopies.empty()) {
+                    return VK_SUCCESS;
+                }
+
+                reclaim();
+
+                uint32_t index;
+                VkResult result = acquireCommandBuffer(index);
+                if(result != VK_SUCCESS) {
+                    return result;
+                }
+                VkCommandBuffer commandBuffer = _commandBuffers[index].get();
+
+                VkCommandBufferBeginInfo beginInfo = {};
+                beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+                beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+                result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+                if(result == VK_SUCCESS) {
+                    recordCopies(commandBuffer);
+                    result = vkEndCommandBuffer(commandBuffer);
+                }
+
+                uint64_t signalValue = _submittedValue + 1;
+                if(result == VK_SUCCESS) {
+                    VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+                    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+                    timelineInfo.signalSemaphoreValueCount = 1;
+                    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+                    VkSubmitInfo submitInfo = {};
+                    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+                    submitInfo.pNext = &timelineInfo;
+                    submitInfo.commandBufferCount = 1;
+                    submitInfo.pCommandBuffers = &commandBuffer;
+                    submitInfo.signalSemaphoreCount = 1;
+                    submitInfo.pSignalSemaphores = &_semaphore.get();
+                    result = vkQueueSubmit(_queue, 1, &submitInfo, VK_NULL_HANDLE);
+                }
+
+                if(result != VK_SUCCESS) {
+                    _freeCommandBuffers.push_back(index);
+                    return result;
+                }
+
+                InflightBatch batch;
+                batch.value = signalValue;
+                batch.ringEnd = _head;
+                batch.commandBuffer = index;
+                _inflight.push_back(batch);
+
+                _submittedValue = signalValue;
+                _stats.uploads += _bufferCopies.size() + _imageCopies.size();
+                _stats.bytes += _pendingBytes;
+                _stats.batches++;
+
+                _bufferCopies.clear();
+                _imageCopies.clear();
+                _pendingBytes = 0;
+                return VK_SUCCESS;
+            }
+
+            bool isComplete(VkUploadToken token) {
+                if(token > _submittedValue) {
+                    return false;
+                }
+                uint64_t value = 0;
+                return vkGetSemaphoreCounterValue(_device, _semaphore.get(), &value) == VK_SUCCESS && value >= token;
+            }
+
+            // flushes the token's batch if it has not been submitted yet
+            VkResult wait(VkUploadToken token, uint64_t timeoutNs) {
+                if(token > _submittedValue) {
+                    VkResult result = flush();
+                    if(result != VK_SUCCESS) {
+                        return result;
+                    }
+                }
+                return waitValue(token, timeoutNs);
+            }
+
+            VkSemaphore getTimelineSemaphore() {
+                return _semaphore.get();
+            }
+
+            const VkUploadStats& getStats() const {
+                return _stats;
+            }
+
+        private:
+            VkUploadService(const VkUploadService&) = delete;
+            VkUploadService& operator=(const VkUploadService&) = delete;
+
+            struct PendingBufferCopy {
+                VkBuffer dst;
+                VkBufferCopy region;
+                // copies of a phase do not overlap each other, phases are separated by barriers
+                uint32_t phase;
+            };
+
+            struct PendingImageCopy {
+                VkImage dst;
+                VkImageLayout layout;
+                VkBufferImageCopy region;
+                uint32_t phase;
+            };
+
+            static VkDeviceSize gcd(VkDeviceSize a, VkDeviceSize b) {
+                while(b != 0) {
+                    VkDeviceSize t = a % b;
+                    a = b;
+                    b = t;
+                }
+                return a;
+            }
+
+            static VkDeviceSize lcm(VkDeviceSize a, VkDeviceSize b) {
+                return a / gcd(a, b) * b;
+            }
+
+            struct InflightBatch {
+                uint64_t value;
+                // ring position (monotonic) up to which the batch used staging space
+                VkDeviceSize ringEnd;
+                uint32_t commandBuffer;
+            };
+
+            VkResult flushIfFull() {
+                if(_bufferCopies.size() + _imageCopies.size() >= _maxCopiesPerBatch) {
+                    return flush();
+                }
+                return VK_SUCCESS;
+            }
+
+            VkResult stage(const void* data, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& stagingOffset) {
+                if(size == 0) {
+                    return VK_ERROR_UNKNOWN;
+                }
+                VkResult result = reserve(size, alignment, stagingOffset);
+                if(result != VK_SUCCESS) {
+                    return result;
+                }
+                memcpy(_mapped + stagingOffset, data, (size_t)size);
+                _pendingBytes += size;
+                return VK_SUCCESS;
+            }
+
+            // _head and _tail grow monotonically; the ring offset is the position modulo the ring size.
+            // The ring offset (not the monotonic position) is aligned, so alignments need not divide the ring size.
+            VkResult reserve(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& stagingOffset) {
+                if(size > _ringSize) {
+                    return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+                }
+
+                while(true) {
+                    VkDeviceSize headOffset = _head % _ringSize;
+                    VkDeviceSize ringOffset = (headOffset + alignment - 1) / alignment * alignment;
+                    VkDeviceSize begin = _head + (ringOffset - headOffset);
+                    if(ringOffset + size > _ringSize) {
+                        // allocations never straddle the end of the ring
+                        begin = _head + (_ringSize - headOffset);
+                        ringOffset = 0;
+                    }
+                    if(begin + size - _tail <= _ringSize) {
+                        _head = begin + size;
+                        stagingOffset = ringOffset;
+                        return VK_SUCCESS;
+                    }
+
+                    if(_inflight.empty() && _bufferCopies.empty() && _imageCopies.empty()) {
+                        // nothing uses the ring, restart at its beginning
+                        _head = _tail = (_head + _ringSize - 1) / _ringSize * _ringSize;
+                        continue;
+                    }
+
+                    reclaim();
+                    if(begin + size - _tail <= _ringSize) {
+                        continue;
+                    }
+
+                    VkResult result = flush();
+                    if(result != VK_SUCCESS) {
+                        return result;
+                    }
+                    if(!_inflight.empty()) {
+                        result = waitValue(_inflight.front().value, UINT64_MAX);
+                        if(result != VK_SUCCESS) {
+                            return result;
+                        }
+                        reclaim();
+                    }
+                }
+            }
+
+            // returns staging space and command buffers of completed batches
+            void reclaim() {
+                if(_inflight.empty()) {
+                    return;
+                }
+                uint64_t completedValue = 0;
+                if(vkGetSemaphoreCounterValue(_device, _semaphore.get(), &completedValue) != VK_SUCCESS) {
+                    return;
+                }
+                while(!_inflight.empty() && _inflight.front().value <= completedValue) {
+                    _tail = _inflight.front().ringEnd;
+                    _freeCommandBuffers.push_back(_inflight.front().commandBuffer);
+                    _inflight.pop_front();
+                }
+            }
+
+            VkResult waitValue(uint64_t value, uint64_t timeoutNs) {
+                VkSemaphoreWaitInfo waitInfo = {};
+                waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+                waitInfo.semaphoreCount = 1;
+                waitInfo.pSemaphores = &_semaphore.get();
+                waitInfo.pValues = &value;
+                return vkWaitSemaphores(_device, &waitInfo, timeoutNs);
+            }
+
+            VkResult acquireCommandBuffer(uint32_t& index) {
+                if(!_freeCommandBuffers.empty()) {
+                    index = _freeCommandBuffers.back();
+                    _freeCommandBuffers.pop_back();
+                    return VK_SUCCESS;
+                }
+
+                VkCommandBufferAllocateInfo allocInfo = {};
+                allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                allocInfo.commandPool = _commandPool.get();
+                allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+                allocInfo.commandBufferCount = 1;
+
+                VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+                VkResult result = vkAllocateCommandBuffers(_device, &allocInfo, &commandBuffer);
+                if(result != VK_SUCCESS) {
+                    return result;
+                }
+                index = (uint32_t)_commandBuffers.size();
+                _commandBuffers.push_back(VkUniqueHandle<VkCommandBuffer>(commandBuffer, _device, _commandPool.get()));
+                return VK_SUCCESS;
+            }
+
+            static bool overlaps(const VkBufferCopy& a, const VkBufferCopy& b) {
+                return a.dstOffset < b.dstOffset + b.size && b.dstOffset < a.dstOffset + a.size;
+            }
+
+            static bool overlaps(const VkBufferImageCopy& a, const VkBufferImageCopy& b) {
+                const VkImageSubresourceLayers& sa = a.imageSubresource;
+                const VkImageSubresourceLayers& sb = b.imageSubresource;
+                if(sa.mipLevel != sb.mipLevel || (sa.aspectMask & sb.aspectMask) == 0) {
+                    return false;
+                }
+                // VK_REMAINING_ARRAY_LAYERS (~0u) covers every layer from the base
+                uint64_t endA = (uint64_t)sa.baseArrayLayer + sa.layerCount;
+                uint64_t endB = (uint64_t)sb.baseArrayLayer + sb.layerCount;
+                if(sa.baseArrayLayer >= endB || sb.baseArrayLayer >= endA) {
+                    return false;
+                }
+                return overlaps(a.imageOffset.x, a.imageExtent.width, b.imageOffset.x, b.imageExtent.width)
+                    && overlaps(a.imageOffset.y, a.imageExtent.height, b.imageOffset.y, b.imageExtent.height)
+                    && overlaps(a.imageOffset.z, a.imageExtent.depth, b.imageOffset.z, b.imageExtent.depth);
+            }
+
+            static bool overlaps(int32_t offsetA, uint32_t extentA, int32_t offsetB, uint32_t extentB) {
+                return (int64_t)offsetA < (int64_t)offsetB + extentB && (int64_t)offsetB < (int64_t)offsetA + extentA;
+            }
+
+            // Walks the copies of each destination in upload order (copies must be sorted by destination, stably)
+            // and starts a new phase whenever a copy overlaps one already in the current phase.
+            // Returns the number of phases.
+            template<typename Copy>
+            static uint32_t assignPhases(std::vector<Copy>& copies) {
+                uint32_t phaseCount = copies.empty() ? 0 : 1;
+                for(size_t begin = 0; begin < copies.size();) {
+                    size_t end = begin;
+                    size_t phaseBegin = begin;
+                    uint32_t phase = 0;
+                    while(end < copies.size() && copies[end].dst == copies[begin].dst) {
+                        for(size_t i = phaseBegin; i < end; i++) {
+                            if(overlaps(copies[i].region, copies[end].region)) {
+                                phase++;
+                                phaseBegin = end;
+                                break;
+                            }
+                        }
+                        copies[end].phase = phase;
+                        end++;
+                    }
+                    phaseCount = std::max(phaseCount, phase + 1);
+                    begin = end;
+                }
+                return phaseCount;
+            }
+
+            // Copies to the same destination within a phase are merged into a single copy command.
+            // A transfer-to-transfer barrier separates phases so overlapping writes land in upload order.
+            void recordCopies(VkCommandBuffer commandBuffer) {
+                VkBuffer staging = _staging.get();
+
+                std::stable_sort(_bufferCopies.begin(), _bufferCopies.end(), [](const PendingBufferCopy& a, const PendingBufferCopy& b){
+                    return a.dst < b.dst;
+                });
+                std::stable_sort(_imageCopies.begin(), _imageCopies.end(), [](const PendingImageCopy& a, const PendingImageCopy& b){
+                    return a.dst < b.dst;
+                });
+                uint32_t phaseCount = std::max(assignPhases(_bufferCopies), assignPhases(_imageCopies));
+
+                // stable, so upload order is kept among copies of the same destination and phase
+                std::stable_sort(_bufferCopies.begin(), _bufferCopies.end(), [](const PendingBufferCopy& a, const PendingBufferCopy& b){
+                    return a.phase != b.phase ? a.phase < b.phase : a.dst < b.dst;
+                });
+                std::stable_sort(_imageCopies.begin(), _imageCopies.end(), [](const PendingImageCopy& a, const PendingImageCopy& b){
+                    if(a.phase != b.phase) {
+                        return a.phase < b.phase;
+                    }
+                    return a.dst != b.dst ? a.dst < b.dst : a.layout < b.layout;
+                });
+
+                size_t bufferBegin = 0;
+                size_t imageBegin = 0;
+                for(uint32_t phase = 0; phase < phaseCount; phase++) {
+                    if(phase > 0) {
+                        VkMemoryBarrier barrier = {};
+                        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                            1, &barrier, 0, nullptr, 0, nullptr);
+                    }
+
+                    while(bufferBegin < _bufferCopies.size() && _bufferCopies[bufferBegin].phase == phase) {
+                        _bufferRegions.clear();
+                        size_t end = bufferBegin;
+                        while(end < _bufferCopies.size() && _bufferCopies[end].phase == phase
+                            && _bufferCopies[end].dst == _bufferCopies[bufferBegin].dst) {
+                            _bufferRegions.push_back(_bufferCopies[end].region);
+                            end++;
+                        }
+                        vkCmdCopyBuffer(commandBuffer, staging, _bufferCopies[bufferBegin].dst, (uint32_t)_bufferRegions.size(), _bufferRegions.data());
+                        bufferBegin = end;
+                    }
+
+                    while(imageBegin < _imageCopies.size() && _imageCopies[imageBegin].phase == phase) {
+                        _imageRegions.clear();
+                        size_t end = imageBegin;
+                        while(end < _imageCopies.size() && _imageCopies[end].phase == phase
+                            && _imageCopies[end].dst == _imageCopies[imageBegin].dst
+                            && _imageCopies[end].layout == _imageCopies[imageBegin].layout) {
+                            _imageRegions.push_back(_imageCopies[end].region);
+                            end++;
+                        }
+                        vkCmdCopyBufferToImage(commandBuffer, staging, _imageCopies[imageBegin].dst, _imageCopies[imageBegin].layout,
+                            (uint32_t)_imageRegions.size(), _imageRegions.data());
+                        imageBegin = end;
+                    }
+                }
+            }
+
+            VkDevice _device = VK_NULL_HANDLE;
+            VkQueue _queue = VK_NULL_HANDLE;
+            VkDeviceSize _copyOffsetAlignment = 1;
+            uint32_t _maxCopiesPerBatch = 256;
+
+            VkUniqueHandle<VkSemaphore> _semaphore;
+            VkUniqueHandle<VkCommandPool> _commandPool;
+            std::vector<VkUniqueHandle<VkCommandBuffer>> _commandBuffers;
+            std::vector<uint32_t> _freeCommandBuffers;
+
+            VkUniqueBoundBuffer _staging;
+            uint8_t* _mapped = nullptr;
+            VkDeviceSize _ringSize = 0;
+            VkDeviceSize _head = 0;
+            VkDeviceSize _tail = 0;
+
+            uint64_t _submittedValue = 0;
+            std::deque<InflightBatch> _inflight;
+
+            std::vector<PendingBufferCopy> _bufferCopies;
+            std::vector<PendingImageCopy> _imageCopies;
+            // staged bytes of the pending copies, added to the stats once they are submitted
+            VkDeviceSize _pendingBytes = 0;
+            std::vector<VkBufferCopy> _bufferRegions;
+            std::vector<VkBufferImageCopy> _imageRegions;
+
+            VkUploadStats _stats;
+    };
+}
+
+#endif //VK_UPLOAD_SERVICE_H_
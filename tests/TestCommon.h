@@ -0,0 +1,42 @@
+//
+// Minimal check macros shared by the tests; unlike assert they stay active with NDEBUG.
+//
+
+#ifndef VKH_TEST_COMMON_H_
+#define VKH_TEST_COMMON_H_
+
+#include "StubDriver.h"
+#include <stdio.h>
+
+namespace vkh_test {
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    // prints the summary line and returns the process exit code
+    inline int report(const char* name) {
+        if(failures() != 0) {
+            printf("%s: %d check(s) failed\n", name, failures());
+            return 1;
+        }
+        printf("%s: passed\n", name);
+        return 0;
+    }
+}
+
+#define VKH_CHECK(condition) \
+    do { \
+        if(!(condition)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            vkh_test::failures()++; \
+        } \
+    } while(0)
+
+#define VKH_RUN(test) \
+    do { \
+        stub::reset(); \
+        test(); \
+    } while(0)
+
+#endif //VKH_TEST_COMMON_H_
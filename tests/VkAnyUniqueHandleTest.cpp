@@ -0,0 +1,194 @@
+#include "TestCommon.h"
+#include "vkh/VkAnyUniqueHandle.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace vkh;
+
+namespace {
+    VkInstance instance = stub::makeHandle<VkInstance>();
+    VkDevice device = stub::makeHandle<VkDevice>();
+
+    uint32_t addContext(VkCommandPool commandPool, VkDescriptorPool descriptorPool) {
+        VkHandleContext context;
+        context.instance = instance;
+        context.device = device;
+        context.commandPool = commandPool;
+        context.descriptorPool = descriptorPool;
+        return VkHandleContexts::add(context);
+    }
+
+    size_t indexOf(const std::vector<stub::Call>& calls, const char* name) {
+        for(size_t i = 0; i < calls.size(); i++) {
+            if(calls[i].name == name) {
+                return i;
+            }
+        }
+        return calls.size();
+    }
+
+    // children are released before their parents regardless of list order
+    void testReleaseOrder() {
+        VkCommandPool commandPool = stub::makeHandle<VkCommandPool>();
+        VkDescriptorPool descriptorPool = stub::makeHandle<VkDescriptorPool>();
+        uint32_t context = addContext(commandPool, descriptorPool);
+        VKH_CHECK(context != VK_HANDLE_CONTEXT_INVALID);
+
+        std::vector<VkAnyUniqueHandle> handles;
+        handles.push_back(VkAnyUniqueHandle(instance, context));
+        handles.push_back(VkAnyUniqueHandle(device, context));
+        handles.push_back(VkAnyUniqueHandle(commandPool, context));
+        handles.push_back(VkAnyUniqueHandle(stub::makeHandle<VkDeviceMemory>(), context));
+        handles.push_back(VkAnyUniqueHandle(stub::makeHandle<VkImage>(), context));
+        handles.push_back(VkAnyUniqueHandle(stub::makeHandle<VkSurfaceKHR>(), context));
+        handles.push_back(VkAnyUniqueHandle(stub::makeHandle<VkDebugUtilsMessengerEXT>(), context));
+        handles.push_back(VkAnyUniqueHandle(descriptorPool, context));
+        for(int i = 0; i < 3; i++) {
+            handles.push_back(VkAnyUniqueHandle(stub::makeHandle<VkCommandBuffer>(), context));
+            handles.push_back(VkAnyUniqueHandle(stub::makeHandle<VkDescriptorSet>(), context));
+        }
+        handles.push_back(VkAnyUniqueHandle(stub::makeHandle<VkQueue>(), context));
+        handles.push_back(VkAnyUniqueHandle());
+
+        VkAnyUniqueHandle::releaseAll(handles);
+        VKH_CHECK(handles.empty());
+
+        std::vector<stub::Call> calls = stub::calls();
+        VKH_CHECK(calls.size() == 10);
+        VKH_CHECK(stub::countCalls("vkFreeCommandBuffers") == 1);
+        VKH_CHECK(stub::countCalls("vkFreeDescriptorSets") == 1);
+        VKH_CHECK(calls[indexOf(calls, "vkFreeCommandBuffers")].count == 3);
+
+        VKH_CHECK(indexOf(calls, "vkFreeCommandBuffers") < indexOf(calls, "vkDestroyCommandPool"));
+        VKH_CHECK(indexOf(calls, "vkFreeDescriptorSets") < indexOf(calls, "vkDestroyDescriptorPool"));
+        VKH_CHECK(indexOf(calls, "vkDestroyImage") < indexOf(calls, "vkFreeMemory"));
+        VKH_CHECK(indexOf(calls, "vkFreeMemory") < indexOf(calls, "vkDestroyDevice"));
+        VKH_CHECK(indexOf(calls, "vkDestroyCommandPool") < indexOf(calls, "vkDestroyDevice"));
+        VKH_CHECK(indexOf(calls, "vkDestroyDevice") < indexOf(calls, "vkDestroySurfaceKHR"));
+        VKH_CHECK(indexOf(calls, "vkDestroySurfaceKHR") < indexOf(calls, "vkDestroyInstance"));
+        VKH_CHECK(indexOf(calls, "vkDestroyDebugUtilsMessengerEXT") < indexOf(calls, "vkDestroyInstance"));
+        VKH_CHECK(calls.back().name == "vkDestroyInstance");
+
+        VkHandleContexts::remove(context);
+    }
+
+    // pool frees are batched per pool and split into chunks
+    void testPoolBatching() {
+        VkCommandPool poolA = stub::makeHandle<VkCommandPool>();
+        VkCommandPool poolB = stub::makeHandle<VkCommandPool>();
+        uint32_t contextA = addContext(poolA, VK_NULL_HANDLE);
+        uint32_t contextB = addContext(poolB, VK_NULL_HANDLE);
+
+        std::vector<VkAnyUniqueHandle> handles;
+        for(int i = 0; i < 100; i++) {
+            handles.push_back(VkAnyUniqueHandle(stub::makeHandle<VkCommandBuffer>(), i % 2 == 0 ? contextA : contextB));
+        }
+        handles.push_back(VkAnyUniqueHandle(stub::makeHandle<VkCommandBuffer>(), contextA));
+        VkAnyUniqueHandle::releaseAll(handles);
+
+        uint32_t freedA = 0;
+        uint32_t freedB = 0;
+        for(auto& call : stub::calls()) {
+            VKH_CHECK(call.name == "vkFreeCommandBuffers");
+            VKH_CHECK(call.count <= 64);
+            if(call.handle == (uint64_t)poolA) {
+                freedA += call.count;
+            } else if(call.handle == (uint64_t)poolB) {
+                freedB += call.count;
+            }
+        }
+        VKH_CHECK(freedA == 51);
+        VKH_CHECK(freedB == 50);
+        VKH_CHECK(stub::countCalls("vkFreeCommandBuffers") == 2);
+
+        VkHandleContexts::remove(contextA);
+        VkHandleContexts::remove(contextB);
+    }
+
+    void testSingleRelease() {
+        uint32_t context = addContext(VK_NULL_HANDLE, VK_NULL_HANDLE);
+        VkImage image = stub::makeHandle<VkImage>();
+        {
+            VkAnyUniqueHandle handle(image, context);
+            VKH_CHECK(handle.getType() == VK_OBJECT_TYPE_IMAGE);
+            VkAnyUniqueHandle moved(std::move(handle));
+            VKH_CHECK(!handle.isValid());
+            VKH_CHECK(moved.get() == (uint64_t)image);
+        }
+        std::vector<stub::Call> calls = stub::calls();
+        VKH_CHECK(calls.size() == 1);
+        VKH_CHECK(calls[0].name == "vkDestroyImage" && calls[0].handle == (uint64_t)image);
+
+        VkHandleContexts::remove(context);
+    }
+
+    // built with VKH_MAX_HANDLE_CONTEXTS=4
+    void testContextOverflowAndReuse() {
+        std::vector<uint32_t> contexts;
+        for(int i = 0; i < 8; i++) {
+            uint32_t context = addContext(VK_NULL_HANDLE, VK_NULL_HANDLE);
+            if(context == VK_HANDLE_CONTEXT_INVALID) {
+                break;
+            }
+            contexts.push_back(context);
+        }
+        VKH_CHECK(contexts.size() == VKH_MAX_HANDLE_CONTEXTS);
+        VKH_CHECK(addContext(VK_NULL_HANDLE, VK_NULL_HANDLE) == VK_HANDLE_CONTEXT_INVALID);
+
+        // a removed entry is handed out again with the new context
+        VkHandleContexts::remove(contexts[1]);
+        VkCommandPool pool = stub::makeHandle<VkCommandPool>();
+        uint32_t reused = addContext(pool, VK_NULL_HANDLE);
+        VKH_CHECK(reused == contexts[1]);
+        VKH_CHECK(VkHandleContexts::get(reused).commandPool == pool);
+        VKH_CHECK(addContext(VK_NULL_HANDLE, VK_NULL_HANDLE) == VK_HANDLE_CONTEXT_INVALID);
+
+        contexts[1] = reused;
+        for(uint32_t context : contexts) {
+            VkHandleContexts::remove(context);
+        }
+    }
+
+    // a second remove() must not put the entry on the free list twice
+    void testDoubleRemove() {
+        uint32_t context = addContext(VK_NULL_HANDLE, VK_NULL_HANDLE);
+        VKH_CHECK(VkHandleContexts::isValid(context));
+        VkHandleContexts::remove(context);
+        VKH_CHECK(!VkHandleContexts::isValid(context));
+        VkHandleContexts::remove(context);
+
+        VkCommandPool poolA = stub::makeHandle<VkCommandPool>();
+        VkCommandPool poolB = stub::makeHandle<VkCommandPool>();
+        uint32_t contextA = addContext(poolA, VK_NULL_HANDLE);
+        uint32_t contextB = addContext(poolB, VK_NULL_HANDLE);
+        VKH_CHECK(contextA != VK_HANDLE_CONTEXT_INVALID);
+        VKH_CHECK(contextB != VK_HANDLE_CONTEXT_INVALID);
+        VKH_CHECK(contextA != contextB);
+        VKH_CHECK(VkHandleContexts::get(contextA).commandPool == poolA);
+        VKH_CHECK(VkHandleContexts::get(contextB).commandPool == poolB);
+
+        // handles are still released with their own pool
+        VkCommandBuffer commandBuffer = stub::makeHandle<VkCommandBuffer>();
+        {
+            VkAnyUniqueHandle handle(commandBuffer, contextA);
+        }
+        std::vector<stub::Call> calls = stub::calls();
+        VKH_CHECK(calls.size() == 1);
+        VKH_CHECK(calls[0].name == "vkFreeCommandBuffers" && calls[0].handle == (uint64_t)poolA);
+
+        VkHandleContexts::remove(contextA);
+        VkHandleContexts::remove(contextB);
+        VKH_CHECK(!VkHandleContexts::isValid(contextA));
+        VKH_CHECK(!VkHandleContexts::isValid(VK_HANDLE_CONTEXT_INVALID));
+    }
+}
+
+int main() {
+    VKH_RUN(testReleaseOrder);
+    VKH_RUN(testPoolBatching);
+    VKH_RUN(testSingleRelease);
+    VKH_RUN(testContextOverflowAndReuse);
+    VKH_RUN(testDoubleRemove);
+    return vkh_test::report("VkAnyUniqueHandleTest");
+}
@@ -0,0 +1,138 @@
+#include "TestCommon.h"
+#include "vkh/VkFenceReactor.h"
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
+#include <vector>
+
+using namespace vkh;
+
+namespace {
+    // fire-and-forget coroutine, runs eagerly until the first suspension
+    struct Task {
+        struct promise_type {
+            Task get_return_object() { return Task(); }
+            std::suspend_never initial_suspend() { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    VkDevice device = stub::makeHandle<VkDevice>();
+
+    bool waitFor(const std::atomic<int>& counter, int expected) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while(counter.load() < expected) {
+            if(std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    Task awaitFence(VkFenceReactor& reactor, VkFence fence, std::atomic<VkResult>& result, std::atomic<int>& done) {
+        result = co_await reactor.wait(fence);
+        done++;
+    }
+
+    // fences signalled by the stub driver's timer resume every waiting coroutine
+    void testTimerSignalledFences() {
+        VkFenceReactor reactor(device);
+
+        const int FENCE_COUNT = 16;
+        std::vector<std::atomic<VkResult>> results(FENCE_COUNT);
+        std::atomic<int> done(0);
+        for(int i = 0; i < FENCE_COUNT; i++) {
+            results[i] = VK_RESULT_MAX_ENUM;
+            VkFence fence = stub::createFence(std::chrono::milliseconds(5 + 3 * (FENCE_COUNT - i)));
+            awaitFence(reactor, fence, results[i], done);
+        }
+        VKH_CHECK(done == 0);
+
+        VKH_CHECK(waitFor(done, FENCE_COUNT));
+        for(auto& result : results) {
+            VKH_CHECK(result == VK_SUCCESS);
+        }
+    }
+
+    void testSignalledFenceDoesNotSuspend() {
+        VkFenceReactor reactor(device);
+        std::atomic<VkResult> result(VK_RESULT_MAX_ENUM);
+        std::atomic<int> done(0);
+
+        awaitFence(reactor, stub::createFence(std::chrono::nanoseconds(0)), result, done);
+        VKH_CHECK(done == 1);
+        VKH_CHECK(result == VK_SUCCESS);
+    }
+
+    void testDeviceLost() {
+        VkFenceReactor reactor(device);
+        std::atomic<VkResult> results[2] = {{VK_RESULT_MAX_ENUM}, {VK_RESULT_MAX_ENUM}};
+        std::atomic<int> done(0);
+
+        awaitFence(reactor, stub::createFence(std::chrono::nanoseconds(-1)), results[0], done);
+        awaitFence(reactor, stub::createFence(std::chrono::nanoseconds(-1)), results[1], done);
+        stub::failFences(VK_ERROR_DEVICE_LOST);
+
+        VKH_CHECK(waitFor(done, 2));
+        VKH_CHECK(results[0] == VK_ERROR_DEVICE_LOST);
+        VKH_CHECK(results[1] == VK_ERROR_DEVICE_LOST);
+    }
+
+    Task awaitTwice(VkFenceReactor& reactor, VkFence first, VkFence second, VkResult* results, std::atomic<int>& done) {
+        results[0] = co_await reactor.wait(first);
+        // resumed by the shutting-down reactor; awaiting again must not park the coroutine forever
+        results[1] = co_await reactor.wait(second);
+        done++;
+    }
+
+    void testShutdownResumesWaiters() {
+        VkResult results[2] = {VK_SUCCESS, VK_SUCCESS};
+        std::atomic<int> done(0);
+        {
+            VkFenceReactor reactor(device);
+            awaitTwice(reactor, stub::createFence(std::chrono::nanoseconds(-1)), stub::createFence(std::chrono::nanoseconds(-1)),
+                results, done);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            VKH_CHECK(done == 0);
+        }
+        VKH_CHECK(done == 1);
+        VKH_CHECK(results[0] == VK_NOT_READY);
+        VKH_CHECK(results[1] == VK_NOT_READY);
+    }
+
+    // the executor hands resumption to another thread
+    void testExecutor() {
+        std::vector<std::thread> workers;
+        std::mutex workersMutex;
+        std::atomic<int> done(0);
+        std::atomic<VkResult> result(VK_RESULT_MAX_ENUM);
+        {
+            VkFenceReactor reactor(device, [&](std::function<void()> task){
+                std::lock_guard<std::mutex> lock(workersMutex);
+                workers.push_back(std::thread(task));
+            }, 100000);
+
+            VkFence fence = stub::createFence(std::chrono::nanoseconds(-1));
+            awaitFence(reactor, fence, result, done);
+            stub::signalFence(fence);
+            VKH_CHECK(waitFor(done, 1));
+        }
+        for(auto& worker : workers) {
+            worker.join();
+        }
+        VKH_CHECK(result == VK_SUCCESS);
+    }
+}
+
+int main() {
+    VKH_RUN(testTimerSignalledFences);
+    VKH_RUN(testSignalledFenceDoesNotSuspend);
+    VKH_RUN(testDeviceLost);
+    VKH_RUN(testShutdownResumesWaiters);
+    VKH_RUN(testExecutor);
+    return vkh_test::report("VkFenceReactorTest");
+}
@@ -0,0 +1,108 @@
+#include "TestCommon.h"
+#include "vkh/VkHandleSlotMap.h"
+
+using namespace vkh;
+
+namespace {
+    VkDevice device = stub::makeHandle<VkDevice>();
+
+    VkUniqueHandle<VkBuffer> makeBuffer() {
+        return VkUniqueHandle<VkBuffer>(stub::makeHandle<VkBuffer>(), device);
+    }
+
+    void testStaleIds() {
+        VkHandleSlotMap<VkBuffer> map;
+        VkUniqueHandle<VkBuffer> buffer = makeBuffer();
+        VkBuffer raw = buffer.get();
+
+        VkHandleId id = map.insert(std::move(buffer));
+        VKH_CHECK(id != VK_NULL_HANDLE_ID);
+        VKH_CHECK(map.contains(id));
+        VKH_CHECK(map.get(id) == raw);
+
+        VKH_CHECK(map.erase(id));
+        VKH_CHECK(stub::countCalls("vkDestroyBuffer") == 1);
+        VKH_CHECK(!map.contains(id));
+        VKH_CHECK(map.get(id) == VK_NULL_HANDLE);
+        VKH_CHECK(!map.erase(id));
+
+        // the slot is reused with a new generation, the old id stays stale
+        VkHandleId reused = map.insert(makeBuffer());
+        VKH_CHECK((reused & VK_HANDLE_ID_INDEX_MASK) == (id & VK_HANDLE_ID_INDEX_MASK));
+        VKH_CHECK(reused != id);
+        VKH_CHECK(!map.contains(id));
+        VKH_CHECK(map.contains(reused));
+
+        VKH_CHECK(!map.contains(VK_NULL_HANDLE_ID));
+        VKH_CHECK(!map.contains(0xFFFFFFFF));
+    }
+
+    void testSlotZeroGenerationWrap() {
+        VkHandleSlotMap<VkBuffer> map;
+        VkHandleId first = map.insert(makeBuffer());
+        VKH_CHECK((first & VK_HANDLE_ID_INDEX_MASK) == 0);
+        map.erase(first);
+
+        // cycle slot 0 through more than a full generation period
+        bool sawNull = false;
+        bool wrapped = false;
+        for(uint32_t i = 0; i < 2 * (VK_HANDLE_ID_GENERATION_MASK + 1); i++) {
+            VkHandleId id = map.insert(makeBuffer());
+            sawNull |= id == VK_NULL_HANDLE_ID;
+            wrapped |= id == first;
+            VKH_CHECK((id & VK_HANDLE_ID_INDEX_MASK) == 0);
+            VKH_CHECK(map.contains(id));
+            VKH_CHECK(map.erase(id));
+        }
+        VKH_CHECK(!sawNull);
+        VKH_CHECK(wrapped);
+        VKH_CHECK(map.empty());
+    }
+
+    void testTakeSwapRemove() {
+        VkHandleSlotMap<VkBuffer> map;
+        VkHandleId ids[4];
+        VkBuffer raws[4];
+        for(int i = 0; i < 4; i++) {
+            VkUniqueHandle<VkBuffer> buffer = makeBuffer();
+            raws[i] = buffer.get();
+            ids[i] = map.insert(std::move(buffer));
+        }
+
+        // taking the first element moves the last one into its dense position
+        VkUniqueHandle<VkBuffer> taken;
+        VKH_CHECK(map.take(ids[0], taken));
+        VKH_CHECK(taken.get() == raws[0]);
+        VKH_CHECK(stub::countCalls("vkDestroyBuffer") == 0);
+        VKH_CHECK(map.size() == 3);
+        VKH_CHECK(map.data()[0] == raws[3]);
+        VKH_CHECK(map.idAt(0) == ids[3]);
+        VKH_CHECK(map.data()[1] == raws[1]);
+        VKH_CHECK(map.data()[2] == raws[2]);
+
+        // the moved element is still reachable through its id
+        for(int i = 1; i < 4; i++) {
+            VKH_CHECK(map.get(ids[i]) == raws[i]);
+        }
+
+        // taking the last element does not move anything
+        VKH_CHECK(map.take(ids[2], taken));
+        VKH_CHECK(stub::countCalls("vkDestroyBuffer") == 1);
+        VKH_CHECK(map.size() == 2);
+        VKH_CHECK(map.data()[0] == raws[3]);
+        VKH_CHECK(map.data()[1] == raws[1]);
+
+        taken.release();
+        map.clear();
+        VKH_CHECK(stub::countCalls("vkDestroyBuffer") == 4);
+        VKH_CHECK(!map.contains(ids[1]));
+        VKH_CHECK(!map.contains(ids[3]));
+    }
+}
+
+int main() {
+    VKH_RUN(testStaleIds);
+    VKH_RUN(testSlotZeroGenerationWrap);
+    VKH_RUN(testTakeSwapRemove);
+    return vkh_test::report("VkHandleSlotMapTest");
+}
@@ -0,0 +1,207 @@
+#include "TestCommon.h"
+#include "vkh/VkUniqueHandle.h"
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+
+using namespace vkh;
+
+// counts global allocations so push() can be checked to be allocation-free
+static std::atomic<size_t> allocationCount(0);
+
+void* operator new(size_t size) {
+    allocationCount++;
+    void* memory = malloc(size == 0 ? 1 : size);
+    if(memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+namespace {
+    const int THREAD_COUNT = 8;
+    const int HANDLES_PER_THREAD = 2000;
+
+    VkDevice device = stub::makeHandle<VkDevice>();
+
+    uint32_t countFreed(const char* name) {
+        uint32_t freed = 0;
+        for(auto& call : stub::calls()) {
+            if(call.name == name) {
+                freed += call.count;
+            }
+        }
+        return freed;
+    }
+
+    // worker threads release command buffers while the owning thread keeps draining;
+    // the small ring wraps many times and overflows whenever the drains fall behind
+    void testConcurrentRelease() {
+        VkCommandPool pool = stub::makeHandle<VkCommandPool>();
+        VkPoolFreeQueue<VkCommandBuffer> queue(device, pool, 64);
+
+        std::vector<std::vector<VkCommandBuffer>> handles(THREAD_COUNT);
+        for(auto& list : handles) {
+            for(int i = 0; i < HANDLES_PER_THREAD; i++) {
+                list.push_back(stub::makeHandle<VkCommandBuffer>());
+            }
+        }
+
+        std::atomic<int> running(THREAD_COUNT);
+        std::vector<std::thread> threads;
+        for(int t = 0; t < THREAD_COUNT; t++) {
+            threads.push_back(std::thread([&, t](){
+                for(VkCommandBuffer handle : handles[t]) {
+                    VkUniqueHandle<VkCommandBuffer> commandBuffer(handle, &queue);
+                }
+                running--;
+            }));
+        }
+
+        uint32_t drained = 0;
+        while(running > 0) {
+            drained += queue.drain();
+        }
+        for(auto& thread : threads) {
+            thread.join();
+        }
+        drained += queue.drain();
+
+        VKH_CHECK(drained == THREAD_COUNT * HANDLES_PER_THREAD);
+        VKH_CHECK(countFreed("vkFreeCommandBuffers") == THREAD_COUNT * HANDLES_PER_THREAD);
+        for(auto& call : stub::calls()) {
+            VKH_CHECK(call.name != "vkFreeCommandBuffers" || call.handle == (uint64_t)pool);
+        }
+        VKH_CHECK(queue.drain() == 0);
+    }
+
+    void testPushDoesNotAllocate() {
+        VkCommandPool pool = stub::makeHandle<VkCommandPool>();
+        VkPoolFreeQueue<VkCommandBuffer> queue(device, pool, 1000);
+        VKH_CHECK(queue.capacity() == 1024);
+
+        std::vector<VkCommandBuffer> handles;
+        for(int i = 0; i < 1024; i++) {
+            handles.push_back(stub::makeHandle<VkCommandBuffer>());
+        }
+
+        std::atomic<size_t> allocations(0);
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 4; t++) {
+            threads.push_back(std::thread([&, t](){
+                size_t before = allocationCount.load();
+                for(int i = t; i < 1024; i += 4) {
+                    queue.push(handles[i]);
+                }
+                allocations += allocationCount.load() - before;
+            }));
+        }
+        for(auto& thread : threads) {
+            thread.join();
+        }
+        // other threads may allocate concurrently, so this is an upper bound that must still be zero
+        VKH_CHECK(allocations == 0);
+        VKH_CHECK(queue.drain() == 1024);
+        VKH_CHECK(stub::countCalls("vkFreeCommandBuffers") == 1);
+    }
+
+    // handles pushed while the ring is full are kept and freed in the same batch
+    void testOverflow() {
+        VkCommandPool pool = stub::makeHandle<VkCommandPool>();
+        VkPoolFreeQueue<VkCommandBuffer> queue(device, pool, 3);
+        VKH_CHECK(queue.capacity() == 4);
+
+        for(int round = 0; round < 3; round++) {
+            for(int i = 0; i < 10; i++) {
+                queue.push(stub::makeHandle<VkCommandBuffer>());
+            }
+            VKH_CHECK(queue.drain() == 10);
+        }
+        VKH_CHECK(stub::countCalls("vkFreeCommandBuffers") == 3);
+        VKH_CHECK(countFreed("vkFreeCommandBuffers") == 30);
+        VKH_CHECK(queue.drain() == 0);
+    }
+
+    void testAllocateAndResetDrain() {
+        VkCommandPool pool = stub::makeHandle<VkCommandPool>();
+        VkPoolFreeQueue<VkCommandBuffer> queue(device, pool);
+
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.commandPool = pool;
+        allocInfo.commandBufferCount = 1;
+        VkCommandBuffer handle = VK_NULL_HANDLE;
+        VKH_CHECK(queue.allocate(allocInfo, &handle) == VK_SUCCESS);
+        {
+            VkUniqueHandle<VkCommandBuffer> commandBuffer(handle, &queue);
+        }
+        VKH_CHECK(stub::countCalls("vkFreeCommandBuffers") == 0);
+
+        // the queued buffer is freed in one call before allocating
+        VKH_CHECK(queue.allocate(allocInfo, &handle) == VK_SUCCESS);
+        VKH_CHECK(stub::countCalls("vkFreeCommandBuffers") == 1);
+
+        {
+            VkUniqueHandle<VkCommandBuffer> commandBuffer(handle, &queue);
+        }
+        VKH_CHECK(queue.reset(0) == VK_SUCCESS);
+        std::vector<stub::Call> calls = stub::calls();
+        VKH_CHECK(calls.size() >= 2);
+        VKH_CHECK(calls[calls.size() - 2].name == "vkFreeCommandBuffers");
+        VKH_CHECK(calls.back().name == "vkResetCommandPool");
+    }
+
+    // descriptor sets released from other threads are dropped by reset() since the pool reset frees them
+    void testDescriptorSetReset() {
+        VkDescriptorPool pool = stub::makeHandle<VkDescriptorPool>();
+        VkPoolFreeQueue<VkDescriptorSet> queue(device, pool);
+
+        std::vector<std::thread> threads;
+        for(int t = 0; t < THREAD_COUNT; t++) {
+            threads.push_back(std::thread([&](){
+                for(int i = 0; i < HANDLES_PER_THREAD; i++) {
+                    VkUniqueHandle<VkDescriptorSet> set(stub::makeHandle<VkDescriptorSet>(), &queue);
+                }
+            }));
+        }
+        for(auto& thread : threads) {
+            thread.join();
+        }
+
+        VKH_CHECK(queue.reset(0) == VK_SUCCESS);
+        VKH_CHECK(stub::countCalls("vkFreeDescriptorSets") == 0);
+        VKH_CHECK(stub::countCalls("vkResetDescriptorPool") == 1);
+        VKH_CHECK(queue.drain() == 0);
+    }
+
+    void testDestructorDrains() {
+        VkDescriptorPool pool = stub::makeHandle<VkDescriptorPool>();
+        {
+            VkPoolFreeQueue<VkDescriptorSet> queue(device, pool);
+            for(int i = 0; i < 3; i++) {
+                VkUniqueHandle<VkDescriptorSet> set(stub::makeHandle<VkDescriptorSet>(), &queue);
+            }
+        }
+        VKH_CHECK(stub::countCalls("vkFreeDescriptorSets") == 1);
+        VKH_CHECK(countFreed("vkFreeDescriptorSets") == 3);
+    }
+}
+
+int main() {
+    VKH_RUN(testConcurrentRelease);
+    VKH_RUN(testPushDoesNotAllocate);
+    VKH_RUN(testOverflow);
+    VKH_RUN(testAllocateAndResetDrain);
+    VKH_RUN(testDescriptorSetReset);
+    VKH_RUN(testDestructorDrains);
+    return vkh_test::report("VkPoolFreeQueueTest");
+}
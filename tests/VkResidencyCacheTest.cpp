@@ -0,0 +1,234 @@
+#include "TestCommon.h"
+#include "vkh/VkResidencyCache.h"
+#include <vector>
+
+using namespace vkh;
+
+namespace {
+    const VkDeviceSize BUDGET = 1000;
+
+    // usage reported by the fake budget source, set by each test
+    VkDeviceSize reportedUsage = 0;
+
+    VkMemoryBudgetSource makeBudgetSource() {
+        return [](){
+            VkMemoryBudget budget;
+            budget.budget = BUDGET;
+            budget.usage = reportedUsage;
+            return budget;
+        };
+    }
+
+    uint32_t addDeviceContext() {
+        VkHandleContext context;
+        context.device = stub::makeHandle<VkDevice>();
+        return VkHandleContexts::add(context);
+    }
+
+    struct Resource {
+        VkImage image;
+        VkDeviceMemory memory;
+    };
+
+    Resource insert(VkResidencyCache& cache, uint32_t context, uint64_t key, VkDeviceSize size) {
+        Resource resource;
+        resource.image = stub::makeHandle<VkImage>();
+        resource.memory = stub::makeHandle<VkDeviceMemory>();
+
+        std::vector<VkAnyUniqueHandle> handles;
+        handles.push_back(VkAnyUniqueHandle(resource.image, context));
+        handles.push_back(VkAnyUniqueHandle(resource.memory, context));
+        cache.insert(key, size, std::move(handles));
+        return resource;
+    }
+
+    bool destroyed(const Resource& resource) {
+        bool image = false;
+        bool memory = false;
+        for(auto& call : stub::calls()) {
+            image = image || (call.name == "vkDestroyImage" && call.handle == (uint64_t)resource.image);
+            // the memory must only be freed after its image
+            memory = memory || (image && call.name == "vkFreeMemory" && call.handle == (uint64_t)resource.memory);
+        }
+        return image && memory;
+    }
+
+    // evicts least recently used first, never what was used this frame
+    void testLruEviction() {
+        uint32_t context = addDeviceContext();
+        {
+            VkResidencyCache cache(makeBudgetSource(), 0.9f, 2);
+            reportedUsage = 0;
+            cache.beginFrame(0);
+            insert(cache, context, 1, 300);
+            Resource second = insert(cache, context, 2, 300);
+            Resource third = insert(cache, context, 3, 300);
+            VKH_CHECK(cache.getResidentBytes() == 900);
+
+            cache.beginFrame(1);
+            VKH_CHECK(cache.touch(1));
+            insert(cache, context, 4, 300);
+
+            // 1200 used, target 900: key 2 is the least recently used
+            reportedUsage = 1200;
+            cache.trim();
+            VKH_CHECK(!cache.contains(2));
+            VKH_CHECK(cache.contains(1) && cache.contains(3) && cache.contains(4));
+            VKH_CHECK(cache.getResidentBytes() == 900);
+            VKH_CHECK(cache.getPendingReleaseBytes() == 300);
+
+            // far over budget: key 3 goes, keys 1 and 4 were used this frame and stay
+            reportedUsage = 5000;
+            cache.trim();
+            VKH_CHECK(!cache.contains(3));
+            VKH_CHECK(cache.contains(1) && cache.contains(4));
+            VKH_CHECK(cache.getResidentBytes() == 600);
+            VKH_CHECK(stub::calls().empty());
+
+            // touching key 1 again leaves key 4 as the least recently used
+            reportedUsage = 600;
+            cache.beginFrame(2);
+            VKH_CHECK(cache.touch(1));
+            cache.beginFrame(3);
+            VKH_CHECK(destroyed(second) && destroyed(third));
+
+            reportedUsage = 1000;
+            cache.trim();
+            VKH_CHECK(!cache.contains(4));
+            VKH_CHECK(cache.contains(1));
+        }
+        VkHandleContexts::remove(context);
+    }
+
+    // memory waiting for deferred destruction is subtracted from the reported usage
+    void testPendingBytesSubtracted() {
+        uint32_t context = addDeviceContext();
+        {
+            VkResidencyCache cache(makeBudgetSource(), 0.9f, 2);
+            reportedUsage = 0;
+            cache.beginFrame(0);
+            insert(cache, context, 1, 400);
+            insert(cache, context, 2, 400);
+            insert(cache, context, 3, 400);
+
+            cache.beginFrame(1);
+            cache.erase(3);
+            VKH_CHECK(cache.getPendingReleaseBytes() == 400);
+
+            // the driver still counts the erased resource: 1200 reported, 800 effective
+            reportedUsage = 1200;
+            cache.trim();
+            VKH_CHECK(cache.contains(1) && cache.contains(2));
+            VKH_CHECK(cache.getMetrics().evictions == 0);
+
+            reportedUsage = 1400;
+            cache.trim();
+            VKH_CHECK(!cache.contains(1));
+            VKH_CHECK(cache.contains(2));
+            VKH_CHECK(cache.getMetrics().evictions == 1);
+        }
+        VkHandleContexts::remove(context);
+    }
+
+    // evicted handles are destroyed framesInFlight frames after the eviction
+    void testDeferredRelease() {
+        uint32_t context = addDeviceContext();
+        {
+            VkResidencyCache cache(makeBudgetSource(), 0.9f, 3);
+            reportedUsage = 0;
+            cache.beginFrame(10);
+            Resource evicted = insert(cache, context, 1, 600);
+            Resource kept = insert(cache, context, 2, 600);
+
+            cache.beginFrame(11);
+            cache.touch(2);
+            reportedUsage = 1200;
+            cache.trim();
+            VKH_CHECK(!cache.contains(1));
+
+            reportedUsage = 600;
+            cache.beginFrame(12);
+            cache.beginFrame(13);
+            VKH_CHECK(stub::calls().empty());
+            VKH_CHECK(cache.getPendingReleaseBytes() == 600);
+
+            cache.beginFrame(14);
+            VKH_CHECK(destroyed(evicted));
+            VKH_CHECK(!destroyed(kept));
+            VKH_CHECK(stub::calls().size() == 2);
+            VKH_CHECK(cache.getPendingReleaseBytes() == 0);
+
+            // clear() releases everything immediately
+            cache.clear();
+            VKH_CHECK(destroyed(kept));
+            VKH_CHECK(cache.getResidentBytes() == 0);
+        }
+        VKH_CHECK(stub::calls().size() == 4);
+        VkHandleContexts::remove(context);
+    }
+
+    // inserting under an existing key retires the old resource through deferred destruction
+    void testReinsertRetiresOldEntry() {
+        uint32_t context = addDeviceContext();
+        {
+            VkResidencyCache cache(makeBudgetSource(), 0.9f, 2);
+            reportedUsage = 0;
+            cache.beginFrame(0);
+            Resource old = insert(cache, context, 7, 500);
+            Resource replacement = insert(cache, context, 7, 200);
+            VKH_CHECK(cache.contains(7));
+            VKH_CHECK(cache.getResidentBytes() == 200);
+            VKH_CHECK(cache.getPendingReleaseBytes() == 500);
+            VKH_CHECK(cache.getMetrics().evictions == 0);
+
+            cache.beginFrame(1);
+            VKH_CHECK(stub::calls().empty());
+            cache.beginFrame(2);
+            VKH_CHECK(destroyed(old));
+            VKH_CHECK(!destroyed(replacement));
+            VKH_CHECK(cache.getPendingReleaseBytes() == 0);
+        }
+        VkHandleContexts::remove(context);
+    }
+
+    void testMetrics() {
+        uint32_t context = addDeviceContext();
+        {
+            VkResidencyCache cache(makeBudgetSource(), 0.5f, 1);
+            reportedUsage = 0;
+            cache.beginFrame(0);
+            VKH_CHECK(!cache.touch(1));
+            insert(cache, context, 1, 100);
+            insert(cache, context, 2, 250);
+            VKH_CHECK(cache.touch(1));
+            VKH_CHECK(cache.touch(2));
+            VKH_CHECK(cache.touch(2));
+
+            // target 500: both go, least recently used first
+            cache.beginFrame(1);
+            reportedUsage = 850;
+            cache.trim();
+            VKH_CHECK(!cache.contains(1) && !cache.contains(2));
+            VKH_CHECK(!cache.touch(2));
+
+            const VkResidencyMetrics& metrics = cache.getMetrics();
+            VKH_CHECK(metrics.hits == 3);
+            VKH_CHECK(metrics.misses == 2);
+            VKH_CHECK(metrics.evictions == 2);
+            VKH_CHECK(metrics.evictedBytes == 350);
+
+            cache.resetMetrics();
+            VKH_CHECK(cache.getMetrics().hits == 0 && cache.getMetrics().evictedBytes == 0);
+        }
+        VkHandleContexts::remove(context);
+    }
+}
+
+int main() {
+    VKH_RUN(testLruEviction);
+    VKH_RUN(testPendingBytesSubtracted);
+    VKH_RUN(testDeferredRelease);
+    VKH_RUN(testReinsertRetiresOldEntry);
+    VKH_RUN(testMetrics);
+    return vkh_test::report("VkResidencyCacheTest");
+}
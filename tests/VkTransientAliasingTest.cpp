@@ -0,0 +1,157 @@
+#include "TestCommon.h"
+#include "vkh/VkTransientAliasing.h"
+#include <vector>
+
+using namespace vkh;
+
+namespace {
+    VkDevice device = stub::makeHandle<VkDevice>();
+
+    VkPhysicalDeviceMemoryProperties makeMemoryProperties(bool withDeviceLocal) {
+        VkPhysicalDeviceMemoryProperties properties = {};
+        properties.memoryTypeCount = 2;
+        properties.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        properties.memoryTypes[1].propertyFlags = withDeviceLocal ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        return properties;
+    }
+
+    VkTransientResourceInfo makeResource(VkDeviceSize size, VkDeviceSize alignment, uint32_t firstPass, uint32_t lastPass) {
+        VkTransientResourceInfo resource = {};
+        resource.requirements.size = size;
+        resource.requirements.alignment = alignment;
+        resource.requirements.memoryTypeBits = 0x3;
+        resource.firstPass = firstPass;
+        resource.lastPass = lastPass;
+        return resource;
+    }
+
+    // no two resources alive in the same pass may share memory
+    void checkPlan(const std::vector<VkTransientResourceInfo>& resources, const VkTransientAliasPlan& plan, VkDeviceSize granularity) {
+        VKH_CHECK(plan.placements.size() == resources.size());
+        for(size_t i = 0; i < resources.size(); i++) {
+            const VkTransientPlacement& a = plan.placements[i];
+            VKH_CHECK(a.offset % resources[i].requirements.alignment == 0);
+            VKH_CHECK(a.offset % granularity == 0);
+            VKH_CHECK(a.offset + resources[i].requirements.size <= plan.heapSizes[a.heap]);
+
+            for(size_t j = i + 1; j < resources.size(); j++) {
+                const VkTransientPlacement& b = plan.placements[j];
+                bool aliveTogether = resources[i].firstPass <= resources[j].lastPass && resources[j].firstPass <= resources[i].lastPass;
+                bool memoryOverlaps = a.heap == b.heap
+                    && a.offset < b.offset + resources[j].requirements.size && b.offset < a.offset + resources[i].requirements.size;
+                VKH_CHECK(!(aliveTogether && memoryOverlaps));
+            }
+        }
+    }
+
+    void testDisjointLifetimesAlias() {
+        std::vector<VkTransientResourceInfo> resources;
+        resources.push_back(makeResource(4096, 256, 0, 1));
+        resources.push_back(makeResource(4096, 256, 2, 3));
+        resources.push_back(makeResource(1024, 256, 0, 3));
+
+        VkTransientAliasPlan plan;
+        VKH_CHECK(planTransientAliasing(resources, makeMemoryProperties(true), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1024, plan));
+        checkPlan(resources, plan, 1024);
+        VKH_CHECK(plan.heapSizes.size() == 1);
+        VKH_CHECK(plan.heapMemoryTypes[0] == 1);
+        VKH_CHECK(plan.placements[0].offset == plan.placements[1].offset);
+        VKH_CHECK(plan.unaliasedSize == 9216);
+        VKH_CHECK(plan.totalSize() == 5120);
+    }
+
+    void testRandomLifetimes() {
+        uint64_t state = 12345;
+        auto next = [&state](){
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        };
+
+        for(int round = 0; round < 20; round++) {
+            std::vector<VkTransientResourceInfo> resources;
+            for(int i = 0; i < 64; i++) {
+                uint32_t firstPass = (uint32_t)(next() % 16);
+                uint32_t lastPass = firstPass + (uint32_t)(next() % 4);
+                VkDeviceSize alignment = (VkDeviceSize)256 << (next() % 5);
+                resources.push_back(makeResource((next() % 64 + 1) * 1000, alignment, firstPass, lastPass));
+            }
+
+            VkTransientAliasPlan plan;
+            VKH_CHECK(planTransientAliasing(resources, makeMemoryProperties(true), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1024, plan));
+            checkPlan(resources, plan, 1024);
+            VKH_CHECK(plan.totalSize() <= plan.unaliasedSize + resources.size() * 4096);
+        }
+    }
+
+    void testPlanningFailureClearsPlan() {
+        std::vector<VkTransientResourceInfo> resources;
+        resources.push_back(makeResource(4096, 256, 0, 1));
+
+        VkTransientAliasPlan plan;
+        VKH_CHECK(planTransientAliasing(resources, makeMemoryProperties(true), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1, plan));
+        VKH_CHECK(!plan.placements.empty());
+
+        VKH_CHECK(!planTransientAliasing(resources, makeMemoryProperties(false), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1, plan));
+        VKH_CHECK(plan.placements.empty());
+        VKH_CHECK(plan.heapSizes.empty());
+        VKH_CHECK(plan.unaliasedSize == 0);
+    }
+
+    void testCreateBindsAndReleases() {
+        stub::setImageRequirements(65536, 4096);
+
+        std::vector<VkTransientImageInfo> images(2);
+        images[0].firstPass = 0;
+        images[0].lastPass = 1;
+        images[1].firstPass = 2;
+        images[1].lastPass = 3;
+        std::vector<VkTransientBufferInfo> buffers(1);
+        buffers[0].createInfo.size = 1000;
+        buffers[0].firstPass = 0;
+        buffers[0].lastPass = 3;
+
+        VkTransientResourceSet set;
+        VKH_CHECK(set.create(device, makeMemoryProperties(true), 1024, images, buffers) == VK_SUCCESS);
+        VKH_CHECK(set.getPlan().totalSize() < set.getPlan().unaliasedSize);
+        VKH_CHECK(set.getImage(0).getMemory() == set.getImage(1).getMemory());
+        VKH_CHECK(stub::countCalls("vkAllocateMemory") == 1);
+        VKH_CHECK(stub::countCalls("vkBindImageMemory2") == 1);
+        VKH_CHECK(stub::countCalls("vkBindBufferMemory2") == 1);
+
+        set.release();
+        VKH_CHECK(set.getPlan().placements.empty());
+        std::vector<stub::Call> calls = stub::calls();
+        VKH_CHECK(calls.back().name == "vkFreeMemory");
+        VKH_CHECK(stub::countCalls("vkDestroyImage") == 2);
+        VKH_CHECK(stub::countCalls("vkDestroyBuffer") == 1);
+        VKH_CHECK(stub::liveAllocations() == 0);
+    }
+
+    // a failed create() must not leave the previous plan behind
+    void testCreateFailureClearsPlan() {
+        std::vector<VkTransientImageInfo> images(1);
+        images[0].firstPass = 0;
+        images[0].lastPass = 0;
+
+        VkTransientResourceSet set;
+        VKH_CHECK(set.create(device, makeMemoryProperties(true), 1024, images, {}) == VK_SUCCESS);
+        VKH_CHECK(set.getPlan().placements.size() == 1);
+
+        VKH_CHECK(set.create(device, makeMemoryProperties(false), 1024, images, {}) == VK_ERROR_FEATURE_NOT_PRESENT);
+        VKH_CHECK(set.getPlan().placements.empty());
+        VKH_CHECK(set.getPlan().heapSizes.empty());
+        VKH_CHECK(stub::countCalls("vkDestroyImage") == 2);
+        VKH_CHECK(stub::liveAllocations() == 0);
+    }
+}
+
+int main() {
+    VKH_RUN(testDisjointLifetimesAlias);
+    VKH_RUN(testRandomLifetimes);
+    VKH_RUN(testPlanningFailureClearsPlan);
+    VKH_RUN(testCreateBindsAndReleases);
+    VKH_RUN(testCreateFailureClearsPlan);
+    return vkh_test::report("VkTransientAliasingTest");
+}
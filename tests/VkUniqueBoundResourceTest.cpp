@@ -0,0 +1,161 @@
+#include "TestCommon.h"
+#include "vkh/VkUniqueBoundResource.h"
+#include <vector>
+
+using namespace vkh;
+
+namespace {
+    VkDevice device = stub::makeHandle<VkDevice>();
+
+    VkUniqueBoundBuffer makeDedicatedBuffer(VkBuffer& buffer, VkDeviceMemory& memory) {
+        buffer = stub::makeHandle<VkBuffer>();
+        memory = stub::makeHandle<VkDeviceMemory>();
+        return VkUniqueBoundBuffer(VkUniqueHandle<VkBuffer>(buffer, device), VkUniqueHandle<VkDeviceMemory>(memory, device));
+    }
+
+    // the dedicated memory is freed only after the resource is destroyed
+    void testDedicatedReleaseOrder() {
+        VkBuffer buffer;
+        VkDeviceMemory memory;
+        {
+            VkUniqueBoundBuffer bound = makeDedicatedBuffer(buffer, memory);
+            VKH_CHECK(bound.get() == buffer);
+            VKH_CHECK(bound.getMemory() == memory);
+            VKH_CHECK(bound.getOffset() == 0);
+            VKH_CHECK(stub::calls().empty());
+        }
+        std::vector<stub::Call> calls = stub::calls();
+        VKH_CHECK(calls.size() == 2);
+        VKH_CHECK(calls[0].name == "vkDestroyBuffer" && calls[0].handle == (uint64_t)buffer);
+        VKH_CHECK(calls[1].name == "vkFreeMemory" && calls[1].handle == (uint64_t)memory);
+
+        VkImage image = stub::makeHandle<VkImage>();
+        VkDeviceMemory imageMemory = stub::makeHandle<VkDeviceMemory>();
+        VkUniqueBoundImage boundImage(VkUniqueHandle<VkImage>(image, device), VkUniqueHandle<VkDeviceMemory>(imageMemory, device), 4096);
+        VKH_CHECK(boundImage.getOffset() == 4096);
+        boundImage.release();
+        calls = stub::calls();
+        VKH_CHECK(calls.size() == 4);
+        VKH_CHECK(calls[2].name == "vkDestroyImage" && calls[2].handle == (uint64_t)image);
+        VKH_CHECK(calls[3].name == "vkFreeMemory" && calls[3].handle == (uint64_t)imageMemory);
+        VKH_CHECK(!boundImage.isValid());
+        VKH_CHECK(boundImage.getMemory() == VK_NULL_HANDLE);
+    }
+
+    // the allocator callback runs once, after the resource is destroyed, and the shared memory is not freed
+    void testSubAllocationReleaseOrder() {
+        VkImage image = stub::makeHandle<VkImage>();
+        VkDeviceMemory heap = stub::makeHandle<VkDeviceMemory>();
+        int releases = 0;
+        bool destroyedFirst = false;
+        {
+            VkUniqueBoundImage bound(VkUniqueHandle<VkImage>(image, device), heap, 65536, [&](){
+                std::vector<stub::Call> calls = stub::calls();
+                destroyedFirst = calls.size() == 1 && calls[0].name == "vkDestroyImage" && calls[0].handle == (uint64_t)image;
+                releases++;
+            });
+            VKH_CHECK(bound.getMemory() == heap);
+            VKH_CHECK(bound.getOffset() == 65536);
+
+            bound.release();
+            VKH_CHECK(releases == 1);
+        }
+        VKH_CHECK(releases == 1);
+        VKH_CHECK(destroyedFirst);
+        VKH_CHECK(stub::countCalls("vkFreeMemory") == 0);
+    }
+
+    // moved-from objects release nothing; assigning over a live object releases the old resource first
+    void testMove() {
+        int releases = 0;
+        VkBuffer buffer = stub::makeHandle<VkBuffer>();
+        VkDeviceMemory heap = stub::makeHandle<VkDeviceMemory>();
+        VkUniqueBoundBuffer source(VkUniqueHandle<VkBuffer>(buffer, device), heap, 256, [&](){ releases++; });
+
+        VkUniqueBoundBuffer moved(std::move(source));
+        VKH_CHECK(!source.isValid());
+        VKH_CHECK(source.getMemory() == VK_NULL_HANDLE);
+        VKH_CHECK(moved.get() == buffer);
+        VKH_CHECK(moved.getOffset() == 256);
+        source.release();
+        VKH_CHECK(stub::calls().empty());
+        VKH_CHECK(releases == 0);
+
+        VkBuffer oldBuffer;
+        VkDeviceMemory oldMemory;
+        VkUniqueBoundBuffer target = makeDedicatedBuffer(oldBuffer, oldMemory);
+        target = std::move(moved);
+        std::vector<stub::Call> calls = stub::calls();
+        VKH_CHECK(calls.size() == 2);
+        VKH_CHECK(calls[0].name == "vkDestroyBuffer" && calls[0].handle == (uint64_t)oldBuffer);
+        VKH_CHECK(calls[1].name == "vkFreeMemory" && calls[1].handle == (uint64_t)oldMemory);
+        VKH_CHECK(target.get() == buffer);
+        VKH_CHECK(releases == 0);
+
+        moved.release();
+        VKH_CHECK(stub::calls().size() == 2);
+        target.release();
+        VKH_CHECK(stub::calls().back().name == "vkDestroyBuffer");
+        VKH_CHECK(stub::calls().back().handle == (uint64_t)buffer);
+        VKH_CHECK(releases == 1);
+    }
+
+    void testBatchedBinds() {
+        std::vector<VkUniqueBoundBuffer> buffers;
+        for(int i = 0; i < 3; i++) {
+            VkBuffer buffer;
+            VkDeviceMemory memory;
+            buffers.push_back(makeDedicatedBuffer(buffer, memory));
+        }
+        VkUniqueBoundImage image(VkUniqueHandle<VkImage>(stub::makeHandle<VkImage>(), device),
+            VkUniqueHandle<VkDeviceMemory>(stub::makeHandle<VkDeviceMemory>(), device));
+
+        VkBatchMemoryBinder binder(device);
+        VKH_CHECK(binder.submit() == VK_SUCCESS);
+        VKH_CHECK(stub::calls().empty());
+
+        for(auto& buffer : buffers) {
+            binder.add(buffer);
+        }
+        binder.add(image);
+        VKH_CHECK(binder.pendingCount() == 4);
+        VKH_CHECK(binder.submit() == VK_SUCCESS);
+        VKH_CHECK(binder.pendingCount() == 0);
+
+        std::vector<stub::Call> calls = stub::calls();
+        VKH_CHECK(calls.size() == 2);
+        VKH_CHECK(calls[0].name == "vkBindBufferMemory2" && calls[0].count == 3);
+        VKH_CHECK(calls[1].name == "vkBindImageMemory2" && calls[1].count == 1);
+    }
+
+    // a failed buffer bind still attempts the image binds and reports the buffer error
+    void testBindFailure() {
+        VkBuffer buffer;
+        VkDeviceMemory memory;
+        VkUniqueBoundBuffer boundBuffer = makeDedicatedBuffer(buffer, memory);
+        VkUniqueBoundImage image(VkUniqueHandle<VkImage>(stub::makeHandle<VkImage>(), device),
+            VkUniqueHandle<VkDeviceMemory>(stub::makeHandle<VkDeviceMemory>(), device));
+
+        VkBatchMemoryBinder binder(device);
+        binder.add(boundBuffer);
+        binder.add(image);
+        stub::failNextBufferBind(VK_ERROR_OUT_OF_DEVICE_MEMORY);
+        VKH_CHECK(binder.submit() == VK_ERROR_OUT_OF_DEVICE_MEMORY);
+        VKH_CHECK(binder.pendingCount() == 0);
+        VKH_CHECK(stub::countCalls("vkBindBufferMemory2") == 1);
+        VKH_CHECK(stub::countCalls("vkBindImageMemory2") == 1);
+
+        // nothing is left over for the next submit
+        VKH_CHECK(binder.submit() == VK_SUCCESS);
+        VKH_CHECK(stub::calls().size() == 2);
+    }
+}
+
+int main() {
+    VKH_RUN(testDedicatedReleaseOrder);
+    VKH_RUN(testSubAllocationReleaseOrder);
+    VKH_RUN(testMove);
+    VKH_RUN(testBatchedBinds);
+    VKH_RUN(testBindFailure);
+    return vkh_test::report("VkUniqueBoundResourceTest");
+}
@@ -0,0 +1,306 @@
+#include "TestCommon.h"
+#include "vkh/VkUploadService.h"
+#include <vector>
+#include <string.h>
+
+using namespace vkh;
+
+namespace {
+    VkDevice device = stub::makeHandle<VkDevice>();
+    VkQueue queue = stub::makeHandle<VkQueue>();
+
+    VkPhysicalDeviceMemoryProperties makeMemoryProperties() {
+        VkPhysicalDeviceMemoryProperties properties = {};
+        properties.memoryTypeCount = 2;
+        properties.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        properties.memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        return properties;
+    }
+
+    VkResult createService(VkUploadService& service, VkDeviceSize ringSize, VkDeviceSize copyOffsetAlignment) {
+        return service.create(device, makeMemoryProperties(), queue, 0, ringSize, copyOffsetAlignment, 256, nullptr);
+    }
+
+    // the staging ring is the only memory the service allocates
+    const uint8_t* mapStaging() {
+        for(auto& call : stub::calls()) {
+            if(call.name == "vkAllocateMemory") {
+                void* data = nullptr;
+                vkMapMemory(device, (VkDeviceMemory)call.handle, 0, VK_WHOLE_SIZE, 0, &data);
+                return (const uint8_t*)data;
+            }
+        }
+        return nullptr;
+    }
+
+    VkBufferImageCopy makeRegion(int32_t x, int32_t y, uint32_t width, uint32_t height, uint32_t mipLevel, uint32_t layer) {
+        VkBufferImageCopy region = {};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = mipLevel;
+        region.imageSubresource.baseArrayLayer = layer;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset.x = x;
+        region.imageOffset.y = y;
+        region.imageExtent.width = width;
+        region.imageExtent.height = height;
+        region.imageExtent.depth = 1;
+        return region;
+    }
+
+    size_t countCommands(const stub::Submission& submission, stub::Command::Kind kind) {
+        size_t count = 0;
+        for(auto& command : submission.commands) {
+            count += command.kind == kind ? 1 : 0;
+        }
+        return count;
+    }
+
+    void testMergedCopiesAndData() {
+        VkUploadService service;
+        VKH_CHECK(createService(service, 4096, 1) == VK_SUCCESS);
+
+        VkBuffer dst = stub::makeHandle<VkBuffer>();
+        const char first[] = "first";
+        const char second[] = "second";
+        VkUploadToken token = 0;
+        VKH_CHECK(service.uploadBuffer(dst, 0, first, sizeof(first), token) == VK_SUCCESS);
+        VKH_CHECK(service.uploadBuffer(dst, 64, second, sizeof(second), token) == VK_SUCCESS);
+        VKH_CHECK(token == 1);
+        VKH_CHECK(!service.isComplete(token));
+        VKH_CHECK(service.wait(token, UINT64_MAX) == VK_SUCCESS);
+        VKH_CHECK(service.isComplete(token));
+
+        std::vector<stub::Submission> submissions = stub::submissions();
+        VKH_CHECK(submissions.size() == 1);
+        VKH_CHECK(submissions[0].signalValue == token);
+        VKH_CHECK(submissions[0].commands.size() == 1);
+
+        const stub::Command& copy = submissions[0].commands[0];
+        VKH_CHECK(copy.kind == stub::Command::COPY_BUFFER);
+        VKH_CHECK(copy.dst == (uint64_t)dst);
+        VKH_CHECK(copy.bufferRegions.size() == 2);
+
+        const uint8_t* staging = mapStaging();
+        VKH_CHECK(memcmp(staging + copy.bufferRegions[0].srcOffset, first, sizeof(first)) == 0);
+        VKH_CHECK(memcmp(staging + copy.bufferRegions[1].srcOffset, second, sizeof(second)) == 0);
+
+        VKH_CHECK(service.getStats().uploads == 2);
+        VKH_CHECK(service.getStats().bytes == sizeof(first) + sizeof(second));
+        VKH_CHECK(service.getStats().batches == 1);
+    }
+
+    // an overlapping copy to the same buffer goes after a transfer barrier so the later upload wins
+    void testOverlappingBufferCopies() {
+        VkUploadService service;
+        VKH_CHECK(createService(service, 4096, 1) == VK_SUCCESS);
+
+        VkBuffer a = stub::makeHandle<VkBuffer>();
+        VkBuffer b = stub::makeHandle<VkBuffer>();
+        uint8_t data[100] = {};
+        VkUploadToken token = 0;
+        service.uploadBuffer(a, 0, data, 100, token);
+        service.uploadBuffer(b, 0, data, 10, token);
+        service.uploadBuffer(a, 100, data, 20, token);
+        service.uploadBuffer(a, 50, data, 100, token);
+        service.uploadBuffer(a, 200, data, 10, token);
+        VKH_CHECK(service.flush() == VK_SUCCESS);
+
+        std::vector<stub::Submission> submissions = stub::submissions();
+        VKH_CHECK(submissions.size() == 1);
+        const std::vector<stub::Command>& commands = submissions[0].commands;
+        VKH_CHECK(commands.size() == 4);
+        VKH_CHECK(countCommands(submissions[0], stub::Command::PIPELINE_BARRIER) == 1);
+        if(commands.size() == 4) {
+            VKH_CHECK(commands[0].kind == stub::Command::COPY_BUFFER && commands[0].dst == (uint64_t)a);
+            VKH_CHECK(commands[0].bufferRegions.size() == 2);
+            VKH_CHECK(commands[0].bufferRegions[0].dstOffset == 0);
+            VKH_CHECK(commands[0].bufferRegions[1].dstOffset == 100);
+            VKH_CHECK(commands[1].kind == stub::Command::COPY_BUFFER && commands[1].dst == (uint64_t)b);
+
+            VKH_CHECK(commands[2].kind == stub::Command::PIPELINE_BARRIER);
+            VKH_CHECK(commands[2].barrier.srcAccessMask == VK_ACCESS_TRANSFER_WRITE_BIT);
+            VKH_CHECK(commands[2].barrier.dstAccessMask == VK_ACCESS_TRANSFER_WRITE_BIT);
+
+            VKH_CHECK(commands[3].kind == stub::Command::COPY_BUFFER && commands[3].dst == (uint64_t)a);
+            VKH_CHECK(commands[3].bufferRegions.size() == 2);
+            VKH_CHECK(commands[3].bufferRegions[0].dstOffset == 50);
+            VKH_CHECK(commands[3].bufferRegions[1].dstOffset == 200);
+        }
+    }
+
+    void testOverlappingImageCopies() {
+        VkUploadService service;
+        VKH_CHECK(createService(service, 1 << 20, 1) == VK_SUCCESS);
+
+        VkImage image = stub::makeHandle<VkImage>();
+        std::vector<uint8_t> texels(64 * 64 * 4);
+        VkUploadToken token = 0;
+
+        // different mips, layers and disjoint boxes share a copy command
+        service.uploadImage(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, makeRegion(0, 0, 32, 32, 0, 0), 4, texels.data(), 32 * 32 * 4, token);
+        service.uploadImage(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, makeRegion(32, 0, 32, 32, 0, 0), 4, texels.data(), 32 * 32 * 4, token);
+        service.uploadImage(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, makeRegion(0, 0, 32, 32, 1, 0), 4, texels.data(), 32 * 32 * 4, token);
+        service.uploadImage(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, makeRegion(0, 0, 32, 32, 0, 1), 4, texels.data(), 32 * 32 * 4, token);
+        VKH_CHECK(service.flush() == VK_SUCCESS);
+
+        std::vector<stub::Submission> submissions = stub::submissions();
+        VKH_CHECK(submissions.back().commands.size() == 1);
+        VKH_CHECK(submissions.back().commands[0].imageRegions.size() == 4);
+
+        // a box overlapping an earlier one on the same mip and layer is split off
+        service.uploadImage(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, makeRegion(0, 0, 32, 32, 0, 0), 4, texels.data(), 32 * 32 * 4, token);
+        service.uploadImage(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, makeRegion(16, 16, 32, 32, 0, 0), 4, texels.data(), 32 * 32 * 4, token);
+        VKH_CHECK(service.flush() == VK_SUCCESS);
+
+        submissions = stub::submissions();
+        const std::vector<stub::Command>& commands = submissions.back().commands;
+        VKH_CHECK(commands.size() == 3);
+        if(commands.size() == 3) {
+            VKH_CHECK(commands[0].kind == stub::Command::COPY_BUFFER_TO_IMAGE && commands[0].imageRegions[0].imageOffset.x == 0);
+            VKH_CHECK(commands[1].kind == stub::Command::PIPELINE_BARRIER);
+            VKH_CHECK(commands[2].kind == stub::Command::COPY_BUFFER_TO_IMAGE && commands[2].imageRegions[0].imageOffset.x == 16);
+        }
+    }
+
+    // a failed submit keeps the uploads queued under the same token and counts nothing
+    void testSubmitFailureKeepsUploads() {
+        VkUploadService service;
+        VKH_CHECK(createService(service, 4096, 1) == VK_SUCCESS);
+
+        VkBuffer dst = stub::makeHandle<VkBuffer>();
+        uint8_t data[32] = {};
+        VkUploadToken token = 0;
+        VKH_CHECK(service.uploadBuffer(dst, 0, data, sizeof(data), token) == VK_SUCCESS);
+
+        stub::failNextSubmit(VK_ERROR_DEVICE_LOST);
+        VKH_CHECK(service.flush() == VK_ERROR_DEVICE_LOST);
+        VKH_CHECK(service.getStats().uploads == 0);
+        VKH_CHECK(service.getStats().bytes == 0);
+        VKH_CHECK(service.getStats().batches == 0);
+        VKH_CHECK(!service.isComplete(token));
+
+        // another upload joins the retried batch
+        VkUploadToken secondToken = 0;
+        VKH_CHECK(service.uploadBuffer(dst, 64, data, sizeof(data), secondToken) == VK_SUCCESS);
+        VKH_CHECK(secondToken == token);
+
+        VKH_CHECK(service.wait(token, UINT64_MAX) == VK_SUCCESS);
+        std::vector<stub::Submission> submissions = stub::submissions();
+        VKH_CHECK(submissions.size() == 1);
+        VKH_CHECK(submissions[0].signalValue == token);
+        VKH_CHECK(submissions[0].commands.size() == 1 && submissions[0].commands[0].bufferRegions.size() == 2);
+        VKH_CHECK(service.getStats().uploads == 2);
+        VKH_CHECK(service.getStats().bytes == 2 * sizeof(data));
+        VKH_CHECK(service.getStats().batches == 1);
+
+        // the command buffer of the failed attempt was reused rather than leaked
+        VKH_CHECK(stub::countCalls("vkAllocateCommandBuffers") == 1);
+    }
+
+    void testStagingAlignment() {
+        VkUploadService service;
+        VKH_CHECK(createService(service, 1 << 16, 1) == VK_SUCCESS);
+
+        VkBuffer buffer = stub::makeHandle<VkBuffer>();
+        VkImage image = stub::makeHandle<VkImage>();
+        uint8_t data[256] = {};
+        VkUploadToken token = 0;
+
+        // 3, 6 and 12 byte texels (e.g. RGB8, RGB16, RGB32) need offsets that are multiples of 12
+        const uint32_t texelSizes[] = {12, 3, 6, 16, 8};
+        const VkDeviceSize expected[] = {12, 12, 12, 16, 8};
+        for(size_t i = 0; i < sizeof(texelSizes) / sizeof(texelSizes[0]); i++) {
+            // misalign the ring head first
+            service.uploadBuffer(buffer, i * 16, data, 5, token);
+            service.uploadImage(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, makeRegion((int32_t)i * 4, 0, 4, 1, 0, 0), texelSizes[i],
+                data, 4 * texelSizes[i], token);
+        }
+        VKH_CHECK(service.flush() == VK_SUCCESS);
+
+        std::vector<stub::Submission> submissions = stub::submissions();
+        for(auto& command : submissions.back().commands) {
+            if(command.kind == stub::Command::COPY_BUFFER_TO_IMAGE) {
+                VKH_CHECK(command.imageRegions.size() == 5);
+                for(size_t i = 0; i < command.imageRegions.size() && i < 5; i++) {
+                    VKH_CHECK(command.imageRegions[i].bufferOffset % expected[i] == 0);
+                }
+            }
+        }
+
+        // optimalBufferCopyOffsetAlignment applies to every upload
+        VkUploadService aligned;
+        VKH_CHECK(createService(aligned, 1 << 16, 64) == VK_SUCCESS);
+        aligned.uploadBuffer(buffer, 0, data, 5, token);
+        aligned.uploadBuffer(buffer, 16, data, 5, token);
+        aligned.uploadImage(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, makeRegion(0, 0, 4, 1, 0, 0), 12, data, 48, token);
+        VKH_CHECK(aligned.flush() == VK_SUCCESS);
+
+        submissions = stub::submissions();
+        for(auto& command : submissions.back().commands) {
+            for(auto& region : command.bufferRegions) {
+                VKH_CHECK(region.srcOffset % 64 == 0);
+            }
+            for(auto& region : command.imageRegions) {
+                VKH_CHECK(region.bufferOffset % 192 == 0);
+            }
+        }
+    }
+
+    void testRejectsEmptyUploads() {
+        VkUploadService service;
+        VKH_CHECK(createService(service, 4096, 1) == VK_SUCCESS);
+
+        uint8_t data[4] = {};
+        VkUploadToken token = 0;
+        VKH_CHECK(service.uploadBuffer(stub::makeHandle<VkBuffer>(), 0, data, 0, token) == VK_ERROR_UNKNOWN);
+        VKH_CHECK(service.uploadImage(stub::makeHandle<VkImage>(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, makeRegion(0, 0, 1, 1, 0, 0), 4,
+            data, 0, token) == VK_ERROR_UNKNOWN);
+        VKH_CHECK(service.uploadImage(stub::makeHandle<VkImage>(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, makeRegion(0, 0, 1, 1, 0, 0), 0,
+            data, 4, token) == VK_ERROR_UNKNOWN);
+        VKH_CHECK(service.uploadBuffer(stub::makeHandle<VkBuffer>(), 0, data, 8192, token) == VK_ERROR_OUT_OF_DEVICE_MEMORY);
+        VKH_CHECK(service.flush() == VK_SUCCESS);
+        VKH_CHECK(stub::submissions().empty());
+    }
+
+    // uploads larger in total than the ring wait for earlier batches to free staging space
+    void testRingWrapAround() {
+        stub::setCopyLatency(std::chrono::microseconds(200), 0.0);
+
+        VkUploadService service;
+        VKH_CHECK(createService(service, 1024, 1) == VK_SUCCESS);
+
+        VkBuffer dst = stub::makeHandle<VkBuffer>();
+        std::vector<uint8_t> data(300);
+        VkUploadToken token = 0;
+        for(int i = 0; i < 20; i++) {
+            memset(data.data(), i, data.size());
+            VKH_CHECK(service.uploadBuffer(dst, (VkDeviceSize)i * 300, data.data(), data.size(), token) == VK_SUCCESS);
+        }
+        VKH_CHECK(service.wait(token, UINT64_MAX) == VK_SUCCESS);
+        VKH_CHECK(service.getStats().uploads == 20);
+        VKH_CHECK(service.getStats().batches > 1);
+
+        // uploads never straddle the end of the ring
+        for(auto& submission : stub::submissions()) {
+            for(auto& command : submission.commands) {
+                for(auto& region : command.bufferRegions) {
+                    VKH_CHECK(region.srcOffset + region.size <= 1024);
+                }
+            }
+        }
+
+        service.release();
+        VKH_CHECK(stub::liveAllocations() == 0);
+    }
+}
+
+int main() {
+    VKH_RUN(testMergedCopiesAndData);
+    VKH_RUN(testOverlappingBufferCopies);
+    VKH_RUN(testOverlappingImageCopies);
+    VKH_RUN(testSubmitFailureKeepsUploads);
+    VKH_RUN(testStagingAlignment);
+    VKH_RUN(testRejectsEmptyUploads);
+    VKH_RUN(testRingWrapAround);
+    return vkh_test::report("VkUploadServiceTest");
+}
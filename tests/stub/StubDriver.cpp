@@ -0,0 +1,627 @@
+//
+// Stub Vulkan driver, see StubDriver.h
+//
+
+#include "StubDriver.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    struct Timeline {
+        uint64_t value = 0;
+        // signal value and completion time of submissions not yet complete, in submission order
+        std::deque<std::pair<uint64_t, Clock::time_point>> signals;
+    };
+
+    struct Driver {
+        std::mutex mutex;
+        std::condition_variable signaled;
+        bool recording = true;
+
+        std::vector<stub::Call> calls;
+        std::vector<stub::Submission> submissions;
+        std::unordered_map<uint64_t, std::vector<stub::Command>> commandBuffers;
+
+        std::unordered_map<uint64_t, Clock::time_point> fences;
+        VkResult fenceFailure = VK_SUCCESS;
+
+        std::unordered_map<uint64_t, Timeline> timelines;
+        std::unordered_map<uint64_t, void*> memory;
+        std::unordered_map<uint64_t, VkDeviceSize> bufferSizes;
+
+        Clock::duration submitLatency = Clock::duration::zero();
+        double bytesPerSecond = 0.0;
+        Clock::time_point queueIdle;
+        VkResult submitFailure = VK_SUCCESS;
+        VkResult bufferBindFailure = VK_SUCCESS;
+
+        VkDeviceSize imageSize = 65536;
+        VkDeviceSize imageAlignment = 4096;
+    };
+
+    Driver& driver() {
+        static Driver instance;
+        return instance;
+    }
+
+    std::atomic<uint64_t> nextHandle(0x1000);
+
+    uint64_t handleOf(const void* handle) {
+        return (uint64_t)(uintptr_t)handle;
+    }
+
+    void record(const char* name, uint64_t handle, uint32_t count) {
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        if(d.recording) {
+            stub::Call call;
+            call.name = name;
+            call.handle = handle;
+            call.count = count;
+            d.calls.push_back(call);
+        }
+    }
+
+    bool fenceSignaled(Driver& d, VkFence fence, Clock::time_point now) {
+        auto it = d.fences.find(handleOf(fence));
+        return it != d.fences.end() && it->second <= now;
+    }
+
+    uint64_t counterValue(Driver& d, VkSemaphore semaphore, Clock::time_point now) {
+        Timeline& timeline = d.timelines[handleOf(semaphore)];
+        while(!timeline.signals.empty() && timeline.signals.front().second <= now) {
+            timeline.value = std::max(timeline.value, timeline.signals.front().first);
+            timeline.signals.pop_front();
+        }
+        return timeline.value;
+    }
+
+    Clock::time_point deadline(uint64_t timeoutNs) {
+        Clock::time_point now = Clock::now();
+        if(timeoutNs >= (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::time_point::max() - now).count()) {
+            return Clock::time_point::max();
+        }
+        return now + std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(timeoutNs));
+    }
+
+    VkDeviceSize commandBytes(const std::vector<stub::Command>& commands) {
+        VkDeviceSize bytes = 0;
+        for(auto& command : commands) {
+            for(auto& region : command.bufferRegions) {
+                bytes += region.size;
+            }
+            for(auto& region : command.imageRegions) {
+                bytes += (VkDeviceSize)region.imageExtent.width * region.imageExtent.height * region.imageExtent.depth * 4;
+            }
+        }
+        return bytes;
+    }
+}
+
+namespace stub {
+    uint64_t nextHandleValue() {
+        return nextHandle++;
+    }
+
+    void reset() {
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.recording = true;
+        d.calls.clear();
+        d.submissions.clear();
+        d.commandBuffers.clear();
+        d.fences.clear();
+        d.fenceFailure = VK_SUCCESS;
+        d.timelines.clear();
+        d.submitLatency = Clock::duration::zero();
+        d.bytesPerSecond = 0.0;
+        d.queueIdle = Clock::time_point();
+        d.submitFailure = VK_SUCCESS;
+        d.bufferBindFailure = VK_SUCCESS;
+        d.imageSize = 65536;
+        d.imageAlignment = 4096;
+    }
+
+    void setRecording(bool enabled) {
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.recording = enabled;
+    }
+
+    std::vector<Call> calls() {
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        return d.calls;
+    }
+
+    size_t countCalls(const char* name) {
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        size_t count = 0;
+        for(auto& call : d.calls) {
+            if(call.name == name) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    std::vector<Submission> submissions() {
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        return d.submissions;
+    }
+
+    VkFence createFence(std::chrono::nanoseconds delay) {
+        VkFence fence = makeHandle<VkFence>();
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.fences[handleOf(fence)] = delay.count() < 0
+            ? Clock::time_point::max()
+            : Clock::now() + std::chrono::duration_cast<Clock::duration>(delay);
+        return fence;
+    }
+
+    void signalFence(VkFence fence) {
+        Driver& d = driver();
+        {
+            std::lock_guard<std::mutex> lock(d.mutex);
+            d.fences[handleOf(fence)] = Clock::now();
+        }
+        d.signaled.notify_all();
+    }
+
+    void failFences(VkResult result) {
+        Driver& d = driver();
+        {
+            std::lock_guard<std::mutex> lock(d.mutex);
+            d.fenceFailure = result;
+        }
+        d.signaled.notify_all();
+    }
+
+    void setCopyLatency(std::chrono::nanoseconds perSubmit, double bytesPerSecond) {
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.submitLatency = std::chrono::duration_cast<Clock::duration>(perSubmit);
+        d.bytesPerSecond = bytesPerSecond;
+    }
+
+    void failNextSubmit(VkResult result) {
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.submitFailure = result;
+    }
+
+    void failNextBufferBind(VkResult result) {
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.bufferBindFailure = result;
+    }
+
+    void setImageRequirements(VkDeviceSize size, VkDeviceSize alignment) {
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        d.imageSize = size;
+        d.imageAlignment = alignment;
+    }
+
+    size_t liveAllocations() {
+        Driver& d = driver();
+        std::lock_guard<std::mutex> lock(d.mutex);
+        return d.memory.size();
+    }
+}
+
+// destruction
+
+#define STUB_DESTROY(function, Parent, Handle) \
+    void function(Parent, Handle handle, const VkAllocationCallbacks*) { \
+        record(#function, handleOf(handle), 1); \
+    }
+
+void vkDestroyInstance(VkInstance instance, const VkAllocationCallbacks*) {
+    record("vkDestroyInstance", handleOf(instance), 1);
+}
+
+void vkDestroyDevice(VkDevice device, const VkAllocationCallbacks*) {
+    record("vkDestroyDevice", handleOf(device), 1);
+}
+
+STUB_DESTROY(vkDestroySemaphore, VkDevice, VkSemaphore)
+STUB_DESTROY(vkDestroyFence, VkDevice, VkFence)
+STUB_DESTROY(vkDestroyImage, VkDevice, VkImage)
+STUB_DESTROY(vkDestroyEvent, VkDevice, VkEvent)
+STUB_DESTROY(vkDestroyQueryPool, VkDevice, VkQueryPool)
+STUB_DESTROY(vkDestroyBufferView, VkDevice, VkBufferView)
+STUB_DESTROY(vkDestroyImageView, VkDevice, VkImageView)
+STUB_DESTROY(vkDestroyShaderModule, VkDevice, VkShaderModule)
+STUB_DESTROY(vkDestroyPipelineCache, VkDevice, VkPipelineCache)
+STUB_DESTROY(vkDestroyPipelineLayout, VkDevice, VkPipelineLayout)
+STUB_DESTROY(vkDestroyRenderPass, VkDevice, VkRenderPass)
+STUB_DESTROY(vkDestroyPipeline, VkDevice, VkPipeline)
+STUB_DESTROY(vkDestroyDescriptorSetLayout, VkDevice, VkDescriptorSetLayout)
+STUB_DESTROY(vkDestroySampler, VkDevice, VkSampler)
+STUB_DESTROY(vkDestroyDescriptorPool, VkDevice, VkDescriptorPool)
+STUB_DESTROY(vkDestroyFramebuffer, VkDevice, VkFramebuffer)
+STUB_DESTROY(vkDestroyCommandPool, VkDevice, VkCommandPool)
+STUB_DESTROY(vkDestroySamplerYcbcrConversion, VkDevice, VkSamplerYcbcrConversion)
+STUB_DESTROY(vkDestroyDescriptorUpdateTemplate, VkDevice, VkDescriptorUpdateTemplate)
+STUB_DESTROY(vkDestroySurfaceKHR, VkInstance, VkSurfaceKHR)
+STUB_DESTROY(vkDestroySwapchainKHR, VkDevice, VkSwapchainKHR)
+STUB_DESTROY(vkDestroyIndirectCommandsLayoutNVX, VkDevice, VkIndirectCommandsLayoutNVX)
+STUB_DESTROY(vkDestroyObjectTableNVX, VkDevice, VkObjectTableNVX)
+STUB_DESTROY(vkDestroyValidationCacheEXT, VkDevice, VkValidationCacheEXT)
+STUB_DESTROY(vkDestroyAccelerationStructureNV, VkDevice, VkAccelerationStructureNV)
+
+namespace {
+    STUB_DESTROY(vkDestroyDebugUtilsMessengerEXT, VkInstance, VkDebugUtilsMessengerEXT)
+    STUB_DESTROY(vkDestroyDebugReportCallbackEXT, VkInstance, VkDebugReportCallbackEXT)
+}
+
+PFN_vkVoidFunction vkGetInstanceProcAddr(VkInstance, const char* pName) {
+    if(strcmp(pName, "vkDestroyDebugUtilsMessengerEXT") == 0) {
+        return (PFN_vkVoidFunction)&vkDestroyDebugUtilsMessengerEXT;
+    }
+    if(strcmp(pName, "vkDestroyDebugReportCallbackEXT") == 0) {
+        return (PFN_vkVoidFunction)&vkDestroyDebugReportCallbackEXT;
+    }
+    return nullptr;
+}
+
+void vkDestroyBuffer(VkDevice, VkBuffer buffer, const VkAllocationCallbacks*) {
+    record("vkDestroyBuffer", handleOf(buffer), 1);
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    d.bufferSizes.erase(handleOf(buffer));
+}
+
+void vkFreeMemory(VkDevice, VkDeviceMemory memory, const VkAllocationCallbacks*) {
+    record("vkFreeMemory", handleOf(memory), 1);
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    auto it = d.memory.find(handleOf(memory));
+    if(it != d.memory.end()) {
+        free(it->second);
+        d.memory.erase(it);
+    }
+}
+
+// pools
+
+void vkFreeCommandBuffers(VkDevice, VkCommandPool commandPool, uint32_t commandBufferCount, const VkCommandBuffer* pCommandBuffers) {
+    record("vkFreeCommandBuffers", handleOf(commandPool), commandBufferCount);
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    for(uint32_t i = 0; i < commandBufferCount; i++) {
+        d.commandBuffers.erase(handleOf(pCommandBuffers[i]));
+    }
+}
+
+VkResult vkFreeDescriptorSets(VkDevice, VkDescriptorPool descriptorPool, uint32_t descriptorSetCount, const VkDescriptorSet*) {
+    record("vkFreeDescriptorSets", handleOf(descriptorPool), descriptorSetCount);
+    return VK_SUCCESS;
+}
+
+VkResult vkAllocateCommandBuffers(VkDevice, const VkCommandBufferAllocateInfo* pAllocateInfo, VkCommandBuffer* pCommandBuffers) {
+    record("vkAllocateCommandBuffers", handleOf(pAllocateInfo->commandPool), pAllocateInfo->commandBufferCount);
+    for(uint32_t i = 0; i < pAllocateInfo->commandBufferCount; i++) {
+        pCommandBuffers[i] = stub::makeHandle<VkCommandBuffer>();
+    }
+    return VK_SUCCESS;
+}
+
+VkResult vkAllocateDescriptorSets(VkDevice, const VkDescriptorSetAllocateInfo* pAllocateInfo, VkDescriptorSet* pDescriptorSets) {
+    record("vkAllocateDescriptorSets", handleOf(pAllocateInfo->descriptorPool), pAllocateInfo->descriptorSetCount);
+    for(uint32_t i = 0; i < pAllocateInfo->descriptorSetCount; i++) {
+        pDescriptorSets[i] = stub::makeHandle<VkDescriptorSet>();
+    }
+    return VK_SUCCESS;
+}
+
+VkResult vkResetCommandPool(VkDevice, VkCommandPool commandPool, VkCommandPoolResetFlags) {
+    record("vkResetCommandPool", handleOf(commandPool), 0);
+    return VK_SUCCESS;
+}
+
+VkResult vkResetDescriptorPool(VkDevice, VkDescriptorPool descriptorPool, VkDescriptorPoolResetFlags) {
+    record("vkResetDescriptorPool", handleOf(descriptorPool), 0);
+    return VK_SUCCESS;
+}
+
+// creation and memory
+
+VkResult vkCreateBuffer(VkDevice, const VkBufferCreateInfo* pCreateInfo, const VkAllocationCallbacks*, VkBuffer* pBuffer) {
+    *pBuffer = stub::makeHandle<VkBuffer>();
+    record("vkCreateBuffer", handleOf(*pBuffer), 1);
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    d.bufferSizes[handleOf(*pBuffer)] = pCreateInfo->size;
+    return VK_SUCCESS;
+}
+
+VkResult vkCreateImage(VkDevice, const VkImageCreateInfo*, const VkAllocationCallbacks*, VkImage* pImage) {
+    *pImage = stub::makeHandle<VkImage>();
+    record("vkCreateImage", handleOf(*pImage), 1);
+    return VK_SUCCESS;
+}
+
+VkResult vkCreateSemaphore(VkDevice, const VkSemaphoreCreateInfo*, const VkAllocationCallbacks*, VkSemaphore* pSemaphore) {
+    *pSemaphore = stub::makeHandle<VkSemaphore>();
+    record("vkCreateSemaphore", handleOf(*pSemaphore), 1);
+    return VK_SUCCESS;
+}
+
+VkResult vkCreateCommandPool(VkDevice, const VkCommandPoolCreateInfo*, const VkAllocationCallbacks*, VkCommandPool* pCommandPool) {
+    *pCommandPool = stub::makeHandle<VkCommandPool>();
+    record("vkCreateCommandPool", handleOf(*pCommandPool), 1);
+    return VK_SUCCESS;
+}
+
+void vkGetBufferMemoryRequirements(VkDevice, VkBuffer buffer, VkMemoryRequirements* pMemoryRequirements) {
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    pMemoryRequirements->size = d.bufferSizes[handleOf(buffer)];
+    pMemoryRequirements->alignment = 256;
+    pMemoryRequirements->memoryTypeBits = 0xFFFFFFFF;
+}
+
+void vkGetImageMemoryRequirements(VkDevice, VkImage, VkMemoryRequirements* pMemoryRequirements) {
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    pMemoryRequirements->size = d.imageSize;
+    pMemoryRequirements->alignment = d.imageAlignment;
+    pMemoryRequirements->memoryTypeBits = 0xFFFFFFFF;
+}
+
+void vkGetPhysicalDeviceMemoryProperties2(VkPhysicalDevice, VkPhysicalDeviceMemoryProperties2* pMemoryProperties) {
+    VkPhysicalDeviceMemoryProperties& properties = pMemoryProperties->memoryProperties;
+    properties.memoryTypeCount = 2;
+    properties.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    properties.memoryTypes[0].heapIndex = 0;
+    properties.memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    properties.memoryTypes[1].heapIndex = 1;
+    properties.memoryHeapCount = 2;
+    properties.memoryHeaps[0].size = 1ull << 32;
+    properties.memoryHeaps[1].size = 1ull << 32;
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT* budget = (VkPhysicalDeviceMemoryBudgetPropertiesEXT*)pMemoryProperties->pNext;
+    if(budget != nullptr && budget->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT) {
+        for(uint32_t heap = 0; heap < properties.memoryHeapCount; heap++) {
+            budget->heapBudget[heap] = properties.memoryHeaps[heap].size;
+            budget->heapUsage[heap] = 0;
+        }
+    }
+}
+
+VkResult vkAllocateMemory(VkDevice, const VkMemoryAllocateInfo* pAllocateInfo, const VkAllocationCallbacks*, VkDeviceMemory* pMemory) {
+    void* data = calloc(1, (size_t)pAllocateInfo->allocationSize);
+    if(data == nullptr) {
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    *pMemory = stub::makeHandle<VkDeviceMemory>();
+    record("vkAllocateMemory", handleOf(*pMemory), 1);
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    d.memory[handleOf(*pMemory)] = data;
+    return VK_SUCCESS;
+}
+
+VkResult vkMapMemory(VkDevice, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize, VkMemoryMapFlags, void** ppData) {
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    auto it = d.memory.find(handleOf(memory));
+    if(it == d.memory.end()) {
+        return VK_ERROR_MEMORY_MAP_FAILED;
+    }
+    *ppData = (uint8_t*)it->second + offset;
+    return VK_SUCCESS;
+}
+
+VkResult vkBindBufferMemory(VkDevice, VkBuffer buffer, VkDeviceMemory, VkDeviceSize) {
+    record("vkBindBufferMemory", handleOf(buffer), 1);
+    return VK_SUCCESS;
+}
+
+VkResult vkBindBufferMemory2(VkDevice, uint32_t bindInfoCount, const VkBindBufferMemoryInfo*) {
+    record("vkBindBufferMemory2", 0, bindInfoCount);
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    VkResult result = d.bufferBindFailure;
+    d.bufferBindFailure = VK_SUCCESS;
+    return result;
+}
+
+VkResult vkBindImageMemory2(VkDevice, uint32_t bindInfoCount, const VkBindImageMemoryInfo*) {
+    record("vkBindImageMemory2", 0, bindInfoCount);
+    return VK_SUCCESS;
+}
+
+// synchronization
+
+VkResult vkGetFenceStatus(VkDevice, VkFence fence) {
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    if(d.fenceFailure != VK_SUCCESS) {
+        return d.fenceFailure;
+    }
+    return fenceSignaled(d, fence, Clock::now()) ? VK_SUCCESS : VK_NOT_READY;
+}
+
+VkResult vkWaitForFences(VkDevice, uint32_t fenceCount, const VkFence* pFences, VkBool32 waitAll, uint64_t timeout) {
+    Clock::time_point end = deadline(timeout);
+    Driver& d = driver();
+    std::unique_lock<std::mutex> lock(d.mutex);
+    while(true) {
+        if(d.fenceFailure != VK_SUCCESS) {
+            return d.fenceFailure;
+        }
+
+        Clock::time_point now = Clock::now();
+        Clock::time_point next = end;
+        uint32_t signaledCount = 0;
+        for(uint32_t i = 0; i < fenceCount; i++) {
+            if(fenceSignaled(d, pFences[i], now)) {
+                signaledCount++;
+            } else {
+                auto it = d.fences.find(handleOf(pFences[i]));
+                if(it != d.fences.end()) {
+                    next = std::min(next, it->second);
+                }
+            }
+        }
+        if(waitAll ? signaledCount == fenceCount : signaledCount > 0) {
+            return VK_SUCCESS;
+        }
+        if(now >= end) {
+            return VK_TIMEOUT;
+        }
+        d.signaled.wait_until(lock, next);
+    }
+}
+
+VkResult vkGetSemaphoreCounterValue(VkDevice, VkSemaphore semaphore, uint64_t* pValue) {
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    *pValue = counterValue(d, semaphore, Clock::now());
+    return VK_SUCCESS;
+}
+
+VkResult vkWaitSemaphores(VkDevice, const VkSemaphoreWaitInfo* pWaitInfo, uint64_t timeout) {
+    Clock::time_point end = deadline(timeout);
+    Driver& d = driver();
+    std::unique_lock<std::mutex> lock(d.mutex);
+    while(true) {
+        Clock::time_point now = Clock::now();
+        Clock::time_point next = end;
+        bool complete = true;
+        for(uint32_t i = 0; i < pWaitInfo->semaphoreCount; i++) {
+            if(counterValue(d, pWaitInfo->pSemaphores[i], now) >= pWaitInfo->pValues[i]) {
+                continue;
+            }
+            complete = false;
+            for(auto& signal : d.timelines[handleOf(pWaitInfo->pSemaphores[i])].signals) {
+                if(signal.first >= pWaitInfo->pValues[i]) {
+                    next = std::min(next, signal.second);
+                }
+            }
+        }
+        if(complete) {
+            return VK_SUCCESS;
+        }
+        if(now >= end) {
+            return VK_TIMEOUT;
+        }
+        d.signaled.wait_until(lock, next);
+    }
+}
+
+// command recording and submission
+
+VkResult vkBeginCommandBuffer(VkCommandBuffer commandBuffer, const VkCommandBufferBeginInfo*) {
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    d.commandBuffers[handleOf(commandBuffer)].clear();
+    return VK_SUCCESS;
+}
+
+VkResult vkEndCommandBuffer(VkCommandBuffer) {
+    return VK_SUCCESS;
+}
+
+void vkCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, uint32_t regionCount, const VkBufferCopy* pRegions) {
+    stub::Command command = {};
+    command.kind = stub::Command::COPY_BUFFER;
+    command.src = handleOf(srcBuffer);
+    command.dst = handleOf(dstBuffer);
+    command.bufferRegions.assign(pRegions, pRegions + regionCount);
+
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    d.commandBuffers[handleOf(commandBuffer)].push_back(command);
+}
+
+void vkCmdCopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkImage dstImage, VkImageLayout,
+    uint32_t regionCount, const VkBufferImageCopy* pRegions) {
+
+    stub::Command command = {};
+    command.kind = stub::Command::COPY_BUFFER_TO_IMAGE;
+    command.src = handleOf(srcBuffer);
+    command.dst = handleOf(dstImage);
+    command.imageRegions.assign(pRegions, pRegions + regionCount);
+
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    d.commandBuffers[handleOf(commandBuffer)].push_back(command);
+}
+
+void vkCmdPipelineBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags, VkPipelineStageFlags, VkDependencyFlags,
+    uint32_t memoryBarrierCount, const VkMemoryBarrier* pMemoryBarriers,
+    uint32_t, const VkBufferMemoryBarrier*, uint32_t, const VkImageMemoryBarrier*) {
+
+    stub::Command command = {};
+    command.kind = stub::Command::PIPELINE_BARRIER;
+    if(memoryBarrierCount > 0) {
+        command.barrier = pMemoryBarriers[0];
+    }
+
+    Driver& d = driver();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    d.commandBuffers[handleOf(commandBuffer)].push_back(command);
+}
+
+VkResult vkQueueSubmit(VkQueue, uint32_t submitCount, const VkSubmitInfo* pSubmits, VkFence fence) {
+    Driver& d = driver();
+    {
+        std::lock_guard<std::mutex> lock(d.mutex);
+        if(d.submitFailure != VK_SUCCESS) {
+            VkResult result = d.submitFailure;
+            d.submitFailure = VK_SUCCESS;
+            return result;
+        }
+
+        for(uint32_t i = 0; i < submitCount; i++) {
+            const VkSubmitInfo& submit = pSubmits[i];
+            const VkTimelineSemaphoreSubmitInfo* timelineInfo = (const VkTimelineSemaphoreSubmitInfo*)submit.pNext;
+
+            VkDeviceSize bytes = 0;
+            for(uint32_t c = 0; c < submit.commandBufferCount; c++) {
+                stub::Submission submission;
+                submission.commandBuffer = submit.pCommandBuffers[c];
+                submission.commands = d.commandBuffers[handleOf(submit.pCommandBuffers[c])];
+                submission.signalValue = timelineInfo != nullptr && timelineInfo->signalSemaphoreValueCount > 0
+                    ? timelineInfo->pSignalSemaphoreValues[0] : 0;
+                bytes += commandBytes(submission.commands);
+                if(d.recording) {
+                    d.submissions.push_back(std::move(submission));
+                }
+            }
+
+            // the queue executes submissions one after another
+            Clock::duration duration = d.submitLatency;
+            if(d.bytesPerSecond > 0.0) {
+                duration += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(bytes / d.bytesPerSecond));
+            }
+            d.queueIdle = std::max(d.queueIdle, Clock::now()) + duration;
+
+            for(uint32_t s = 0; s < submit.signalSemaphoreCount; s++) {
+                uint64_t value = timelineInfo != nullptr && s < timelineInfo->signalSemaphoreValueCount
+                    ? timelineInfo->pSignalSemaphoreValues[s] : 0;
+                d.timelines[handleOf(submit.pSignalSemaphores[s])].signals.push_back(std::make_pair(value, d.queueIdle));
+            }
+        }
+        if(fence != VK_NULL_HANDLE) {
+            d.fences[handleOf(fence)] = d.queueIdle;
+        }
+    }
+    d.signaled.notify_all();
+    return VK_SUCCESS;
+}
@@ -0,0 +1,81 @@
+//
+// Stub Vulkan driver for the tests and benchmarks.
+// Every entry point is thread-safe and records its calls; fences and timeline semaphores
+// complete after simulated delays so asynchronous code paths can be exercised without a GPU.
+//
+
+#ifndef VKH_STUB_DRIVER_H_
+#define VKH_STUB_DRIVER_H_
+
+#include <vulkan/vulkan.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace stub {
+    struct Call {
+        std::string name;
+        uint64_t handle;
+        uint32_t count;
+    };
+
+    struct Command {
+        enum Kind { COPY_BUFFER, COPY_BUFFER_TO_IMAGE, PIPELINE_BARRIER };
+
+        Kind kind;
+        uint64_t src;
+        uint64_t dst;
+        std::vector<VkBufferCopy> bufferRegions;
+        std::vector<VkBufferImageCopy> imageRegions;
+        VkMemoryBarrier barrier;
+    };
+
+    struct Submission {
+        VkCommandBuffer commandBuffer;
+        std::vector<Command> commands;
+        uint64_t signalValue;
+    };
+
+    // clears recorded calls, submissions and settings; handles stay unique across resets
+    void reset();
+
+    // disables call recording, used by the benchmarks
+    void setRecording(bool enabled);
+
+    // snapshot of recorded calls; destroy/free calls carry the handle, batched frees the count
+    std::vector<Call> calls();
+    size_t countCalls(const char* name);
+
+    std::vector<Submission> submissions();
+
+    uint64_t nextHandleValue();
+
+    // returns a fresh non-null handle
+    template<typename T>
+    T makeHandle() {
+        return (T)nextHandleValue();
+    }
+
+    // fence that becomes signaled after the delay; a negative delay never signals until signalFence()
+    VkFence createFence(std::chrono::nanoseconds delay);
+    void signalFence(VkFence fence);
+    // makes vkWaitForFences/vkGetFenceStatus fail with the result
+    void failFences(VkResult result);
+
+    // each submission completes after fixed latency plus size / bytesPerSecond, in submission order
+    void setCopyLatency(std::chrono::nanoseconds perSubmit, double bytesPerSecond);
+    // the next vkQueueSubmit returns the result without executing
+    void failNextSubmit(VkResult result);
+
+    // the next vkBindBufferMemory2 returns the result
+    void failNextBufferBind(VkResult result);
+
+    // size and alignment reported for images, buffers report their create size
+    void setImageRequirements(VkDeviceSize size, VkDeviceSize alignment);
+
+    // number of live vkAllocateMemory allocations
+    size_t liveAllocations();
+}
+
+#endif //VKH_STUB_DRIVER_H_